@@ -1,4 +1,6 @@
 @echo off
 call "C:\Program Files\Microsoft Visual Studio\2022\Professional\VC\Auxiliary\Build\vcvars64.bat"
-cl /EHsc /O2 /utf-8 /I src src\main.cpp src\gui.cpp src\solver.cpp src\strategies.cpp src\sudoku_grid.cpp user32.lib gdi32.lib comctl32.lib /Fe:sudoku.exe
+cl /EHsc /O2 /utf-8 /I src src\main.cpp src\gui.cpp src\solver.cpp src\solution_cache.cpp src\canonical.cpp src\strategies.cpp src\sudoku_grid.cpp src\variant.cpp user32.lib gdi32.lib comctl32.lib /Fe:sudoku.exe
+cl /EHsc /O2 /utf-8 /DSUDOKU_ENABLE_TRACE /I src src\cli.cpp src\batch.cpp src\binary_format.cpp src\corpus_reader.cpp src\enumerator.cpp src\generator.cpp src\minimizer.cpp src\rater.cpp src\server.cpp src\shard.cpp src\solver.cpp src\solver_pool.cpp src\solution_cache.cpp src\canonical.cpp src\checkpoint.cpp src\strategies.cpp src\sudoku_grid.cpp src\telemetry.cpp src\trace.cpp src\variant.cpp src\verifier.cpp /Fe:sudoku_cli.exe
+cl /LD /EHsc /O2 /utf-8 /DSUDOKU_API_EXPORTS /I src src\sudoku_api.cpp src\corpus_reader.cpp src\solver.cpp src\solution_cache.cpp src\canonical.cpp src\strategies.cpp src\sudoku_grid.cpp src\variant.cpp /Fe:sudoku.dll
 del *.obj 2>nul
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+// 고정 크기 스크래치 메모리: 한 번 잡아 둔 블록을 앞에서부터 잘라 쓰고, reset()/rewind()는 위치만 되돌림 (O(1)).
+// 소멸자를 부르지 않으므로 trivially destructible 타입만 담음
+class Arena {
+public:
+    explicit Arena(size_t capacity) : block(new unsigned char[capacity]), size(capacity) {}
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // 초기화하지 않은 T n개, 모자라면 nullptr
+    template <typename T>
+    T* alloc(size_t n) {
+        static_assert(std::is_trivially_destructible<T>::value, "Arena는 소멸자를 부르지 않음");
+        size_t start = (offset + alignof(T) - 1) & ~(alignof(T) - 1);
+        if (start > size || n > (size - start) / sizeof(T)) return nullptr;
+        offset = start + n * sizeof(T);
+        if (offset > peak) peak = offset;
+        return reinterpret_cast<T*>(block.get() + start);
+    }
+
+    size_t mark() const { return offset; }
+    void rewind(size_t position) { offset = position; }
+    void reset() { offset = 0; }
+
+    size_t capacity() const { return size; }
+    size_t used() const { return offset; }
+    size_t highWater() const { return peak; }   // 만든 뒤 가장 많이 쓴 양
+
+private:
+    std::unique_ptr<unsigned char[]> block;     // new[]는 기본 정렬을 보장
+    size_t size;
+    size_t offset = 0;
+    size_t peak = 0;
+};
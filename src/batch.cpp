@@ -0,0 +1,700 @@
+#include "batch.h"
+#include "binary_format.h"
+#include "bounded_queue.h"
+#include "canonical.h"
+#include "checkpoint.h"
+#include "corpus_reader.h"
+#include "minimizer.h"
+#include "rater.h"
+#include "solution_cache.h"
+#include "solver.h"
+#include "solver_pool.h"
+#include "telemetry.h"
+#include "trace.h"
+#include "verifier.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace Batch {
+
+namespace {
+
+// 매핑한 입력은 파일 크기에 맞춰 이 범위에서 자르고, 스트림 입력은 STREAM_CHUNK_BYTES씩 읽음
+const size_t CHUNK_BYTES = 1u << 20;
+const size_t MIN_CHUNK_BYTES = 16u << 10;
+const size_t STREAM_CHUNK_BYTES = 256u << 10;
+const int CHECKPOINT_SECONDS = 10;
+
+struct ChunkResult {
+    std::string output;
+    std::vector<uint64_t> lines;    // 인덱스용 줄 번호 (텍스트 입력은 청크 기준)
+    uint64_t lineCount = 0;
+    std::vector<Trace::Record> trace;
+    std::vector<Verifier::Mismatch> mismatches;
+    Stats stats;
+};
+
+struct Job {
+    const char* begin;
+    const char* end;
+    uint64_t firstRecord;           // 바이너리 입력
+    uint64_t lastRecord;
+};
+
+// 파이프라인을 도는 칸: 리더가 청크를 채우고, 작업자가 풀고, 작성기가 쓴 뒤 리더에게 돌려줌.
+// 칸 수가 고정이라 입력 크기와 상관없이 메모리가 일정하고, 예열 뒤에는 버퍼도 다시 할당하지 않음
+struct Slot {
+    uint64_t seq = 0;               // 입력 순서 (작성기가 이 순서로 씀)
+    Job job;
+    std::vector<char> buffer;       // 스트림 입력: 읽어 온 줄들
+    ChunkResult result;
+};
+
+// 입력을 청크 단위로 내줌. 매핑한 파일은 복사 없이 줄 경계에서 자르고,
+// 표준 입력이나 파이프는 칸의 버퍼에 읽어 마지막 개행 뒤의 덜 끝난 줄은 다음 청크로 넘김
+struct Source {
+    const char* pos = nullptr;      // 매핑한 텍스트
+    const char* end = nullptr;
+    const BinaryFormat::Reader* binaryInput = nullptr;
+    uint64_t nextRecord = 0;
+    uint64_t endRecord = 0;
+    uint64_t recordsPerChunk = 1;
+    FILE* stream = nullptr;
+    std::vector<char> carry;
+    bool eof = false;
+    bool error = false;
+    size_t chunkBytes = CHUNK_BYTES;
+
+    bool next(Slot& slot) {
+        if (binaryInput) {
+            if (nextRecord >= endRecord) return false;
+            uint64_t last = std::min(endRecord, nextRecord + recordsPerChunk);
+            slot.job = { (const char*)binaryInput->record(nextRecord), (const char*)binaryInput->record(last), nextRecord, last };
+            nextRecord = last;
+            return true;
+        }
+        if (!stream) {
+            if (pos >= end) return false;
+            const char* q = (size_t)(end - pos) > chunkBytes ? pos + chunkBytes : end;
+            if (q < end) {
+                const char* nl = (const char*)memchr(q, '\n', end - q);
+                q = nl ? nl + 1 : end;
+            }
+            slot.job = { pos, q, 0, 0 };
+            pos = q;
+            return true;
+        }
+        return readStream(slot);
+    }
+
+    bool readStream(Slot& slot) {
+        std::vector<char>& buf = slot.buffer;
+        size_t used = carry.size();
+        if (buf.size() < std::max(chunkBytes, used + 1)) buf.resize(std::max(chunkBytes, used * 2));
+        if (used) memcpy(buf.data(), carry.data(), used);
+        size_t cut;
+        for (;;) {
+            while (!eof && used < buf.size()) {
+                size_t n = fread(buf.data() + used, 1, buf.size() - used, stream);
+                used += n;
+                if (n == 0) {
+                    eof = true;
+                    error = ferror(stream) != 0;
+                }
+            }
+            cut = used;
+            while (cut > 0 && buf[cut - 1] != '\n') cut--;
+            if (eof && (cut == 0 || cut < used)) cut = used;   // 끝에 개행이 없는 마지막 줄
+            if (cut > 0) break;
+            if (eof) return false;
+            buf.resize(buf.size() * 2);                         // 버퍼보다 긴 줄
+        }
+        carry.assign(buf.data() + cut, buf.data() + used);
+        slot.job = { buf.data(), buf.data() + cut, 0, 0 };
+        return true;
+    }
+};
+
+struct Context {
+    const Options& options;
+    const BinaryFormat::Reader* binaryInput;
+    uint16_t outputFlags;
+};
+
+// 내놓은 해는 모두 확인하고, 표본으로 뽑힌 퍼즐은 기준 엔진으로 다시 풀어 비교.
+// 기준 엔진의 단계가 기록에 섞이지 않도록 기록기를 잠시 뗌
+void verify(const Context& ctx, SolverContext& sc, bool solved, uint64_t line, ChunkResult& result) {
+    const Options& options = ctx.options;
+    const SudokuGrid& output = sc.solver.getGrid();
+    Verifier::Kind kind = Verifier::Kind::InvalidOutput;
+    bool mismatch = false;
+    if (solved && !Verifier::isValidSolution(sc.puzzle, output)) {
+        mismatch = true;
+        sc.reference = sc.puzzle;
+    } else if (Verifier::sampled(sc.puzzle, options.verifySample)) {
+        Trace::Recorder* recorder = Trace::getRecorder();
+        Trace::setRecorder(nullptr);
+        sc.scratch.reset();
+        result.stats.verified++;
+        mismatch = Verifier::compare(sc.puzzle, solved, options.useBacktrack, output,
+            options.verifyReference, sc.scratch, sc.reference, kind);
+        Trace::setRecorder(recorder);
+    }
+    if (!mismatch) return;
+    result.stats.mismatches++;
+    Verifier::Mismatch m;
+    m.line = line;
+    m.kind = kind;
+    formatGrid(sc.puzzle, m.puzzle);
+    formatGrid(output, m.output);
+    formatGrid(sc.reference, m.reference);
+    result.mismatches.push_back(m);
+}
+
+void emit(const Context& ctx, SolverContext& sc, bool parsed, uint64_t line, ChunkResult& result) {
+    const Options& options = ctx.options;
+    SudokuSolver& solver = sc.solver;
+    result.stats.total++;
+    if (Trace::Recorder* rec = Trace::getRecorder()) rec->begin((uint32_t)line);
+    if (!parsed) {
+        result.stats.invalid++;
+        sc.metrics.count(Telemetry::Invalid);
+        // 텍스트 출력은 줄 위치를 유지, 바이너리 출력은 건너뜀
+        if (options.outputFormat == Format::Text) result.output.push_back('\n');
+        return;
+    }
+    bool verifying = options.verify && options.mode == Mode::Solve;
+    if (verifying) sc.puzzle = solver.getGrid();
+    // 푸는 모드만 지연 시간과 결과를 기록 (검증 시간은 빼고)
+    auto start = std::chrono::steady_clock::now();
+    bool solving = options.mode == Mode::Solve || options.mode == Mode::Minimize || options.mode == Mode::Rate;
+    bool solved = false;
+    Rater::Rating rating;
+    if (options.mode == Mode::Solve) {
+        solved = solver.solve();
+        if (solver.usedBacktrack()) sc.metrics.count(Telemetry::Backtracked);
+    } else if (options.mode == Mode::Canonical) {
+        Canonical::toGrid(Canonical::canonicalize(solver.getGrid()), solver.getGrid());
+    } else if (options.mode == Mode::Minimize) {
+        solved = Minimizer::minimize(solver.getGrid());
+    } else if (options.mode == Mode::Rate) {
+        solved = Rater::rate(solver.getGrid(), rating, options.useBacktrack);
+    }
+    if (solving) {
+        sc.metrics.recordLatency((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+        sc.metrics.count(solved ? Telemetry::Solved : Telemetry::Unsolved);
+        if (solved) result.stats.solved++;
+        else result.stats.unsolved++;
+    }
+    if (verifying) verify(ctx, sc, solved, line, result);
+    if (options.mode == Mode::Rate) {
+        char text[100];
+        formatGrid(solver.getGrid(), text);
+        int n = snprintf(text + 81, sizeof(text) - 81, " %.1f %d\n", rating.score, rating.maxTier);
+        result.output.append(text, 81 + n);
+        return;
+    }
+    if (options.outputFormat == Format::Text) {
+        char text[82];
+        formatGrid(solver.getGrid(), text);
+        text[81] = '\n';
+        result.output.append(text, 82);
+    } else {
+        unsigned char record[BinaryFormat::CELL_BYTES + BinaryFormat::GIVENS_BYTES];
+        BinaryFormat::encode(solver.getGrid(), ctx.outputFlags, record);
+        result.output.append((const char*)record, BinaryFormat::recordSize(ctx.outputFlags));
+        if (options.writeIndex) result.lines.push_back(line);
+    }
+}
+
+inline const char* skipBlanks(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    return p;
+}
+
+// 퍼즐 81글자 뒤의 배치를 layout에 읽어 grid의 유닛 표로 삼음
+bool parseWithLayout(Variant::Kind kind, const char* p, const char* lineEnd, Variant& layout, SudokuGrid& grid) {
+    if (lineEnd - p < 81) return false;
+    const char* text = skipBlanks(p + 81, lineEnd);
+    if (lineEnd - text < 81) return false;
+    if (kind == Variant::Kind::Jigsaw) {
+        if (!Variant::jigsaw(text, layout)) return false;
+    } else {
+        // 케이지 합: 쉼표나 공백으로 구분
+        int sums[Variant::MAX_CAGES];
+        int count = 0;
+        const char* q = skipBlanks(text + 81, lineEnd);
+        while (q < lineEnd) {
+            if (*q < '0' || *q > '9' || count == Variant::MAX_CAGES) return false;
+            int sum = 0;
+            while (q < lineEnd && *q >= '0' && *q <= '9' && sum < 100) sum = sum * 10 + (*q++ - '0');
+            sums[count++] = sum;
+            q = skipBlanks(q, lineEnd);
+            if (q < lineEnd && *q == ',') q = skipBlanks(q + 1, lineEnd);
+        }
+        if (!Variant::killer(text, sums, count, layout)) return false;
+    }
+    grid.setVariant(layout);
+    return CorpusReader::parse(p, lineEnd, grid);
+}
+
+void processText(const Context& ctx, const Job& job, SolverContext& sc, ChunkResult& result) {
+    const char* p = job.begin;
+    while (p < job.end) {
+        const char* lineEnd;
+        const char* next = CorpusReader::nextLine(p, job.end, lineEnd);
+        uint64_t line = result.lineCount++;
+        if (lineEnd == p || *p == '#') { p = next; continue; }
+
+        sc.reset();
+        Variant::Kind kind = ctx.options.variant;
+        bool parsed = kind == Variant::Kind::Jigsaw || kind == Variant::Kind::Killer
+            ? parseWithLayout(kind, p, lineEnd, sc.lineVariant, sc.solver.getGrid())
+            : CorpusReader::parse(p, lineEnd, sc.solver.getGrid());
+        emit(ctx, sc, parsed, line, result);
+        p = next;
+    }
+}
+
+void processBinary(const Context& ctx, const Job& job, SolverContext& sc, ChunkResult& result) {
+    for (uint64_t i = job.firstRecord; i < job.lastRecord; i++) {
+        sc.reset();
+        bool parsed = ctx.binaryInput->decode(i, sc.solver.getGrid());
+        emit(ctx, sc, parsed, ctx.binaryInput->sourceLine(i), result);
+    }
+}
+
+} // namespace
+
+void formatGrid(const SudokuGrid& grid, char* out) {
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            int val = grid.getValue(i, j);
+            out[i * 9 + j] = val ? (char)('0' + val) : '.';
+        }
+    }
+}
+
+bool solveFile(const Options& options, Stats& stats) {
+    // "-"는 표준 입력. 매핑할 수 없는 입력(파이프 등)은 스트림으로 읽음
+    CorpusReader reader;
+    std::unique_ptr<FILE, int (*)(FILE*)> inFile(nullptr, fclose);
+    FILE* in = nullptr;
+    bool opened = false;
+    if (options.inputPath && !strcmp(options.inputPath, "-")) {
+        in = stdin;
+        opened = true;
+    } else if (options.inputPath) {
+        opened = reader.open(options.inputPath);
+        if (!opened) {
+            inFile.reset(fopen(options.inputPath, "rb"));
+            in = inFile.get();
+            opened = in != nullptr;
+        }
+    }
+    if (!opened) {
+        fprintf(stderr, "입력 파일을 열 수 없습니다: %s\n", options.inputPath ? options.inputPath : "");
+        return false;
+    }
+
+    int threads = options.threads > 0 ? options.threads : (int)std::thread::hardware_concurrency();
+    if (threads <= 0) threads = 1;
+
+    Source source;
+    BinaryFormat::Reader binaryInput;
+    bool binary = false;
+    uint64_t rangeBegin = 0, rangeEnd = 0;  // 줄 시작에 맞춘 실제 범위 (파일 입력만, 체크포인트 확인용)
+    if (in) {
+#ifdef _WIN32
+        if (in == stdin) _setmode(_fileno(stdin), _O_BINARY);
+#endif
+        // 처음 몇 바이트로 형식을 판별하고, 읽은 것은 첫 청크 앞에 붙임
+        source.stream = in;
+        source.chunkBytes = STREAM_CHUNK_BYTES;
+        source.carry.resize(BinaryFormat::HEADER_SIZE);
+        source.carry.resize(fread(source.carry.data(), 1, source.carry.size(), in));
+        if (BinaryFormat::isBinary(source.carry.data(), source.carry.size())) {
+            fprintf(stderr, "바이너리 입력은 파일로만 읽을 수 있습니다: %s\n", options.inputPath);
+            return false;
+        }
+        if (options.rangeBegin != 0 || options.rangeEnd != ~0ull) {
+            fprintf(stderr, "입력 범위는 파일 입력에서만 쓸 수 있습니다\n");
+            return false;
+        }
+    } else {
+        binary = BinaryFormat::isBinary(reader.data(), reader.size());
+        if (binary && !binaryInput.attach(reader.data(), reader.size())) {
+            fprintf(stderr, "바이너리 헤더가 올바르지 않습니다: %s\n", options.inputPath);
+            return false;
+        }
+        // 범위가 주어지면 그 안만 처리 (다중 프로세스 조각)
+        uint64_t inputEnd = binary ? binaryInput.count() : reader.size();
+        uint64_t begin = std::min(options.rangeBegin, inputEnd);
+        uint64_t end = std::min(std::max(options.rangeEnd, begin), inputEnd);
+        // 작업자마다 청크 몇 개씩은 돌아가도록 자름
+        size_t bytes = binary ? (size_t)(end - begin) * binaryInput.header().recordSize : (size_t)(end - begin);
+        source.chunkBytes = std::min(CHUNK_BYTES, std::max(MIN_CHUNK_BYTES, bytes / ((size_t)threads * 4)));
+        if (binary) {
+            source.binaryInput = &binaryInput;
+            source.nextRecord = begin;
+            source.endRecord = end;
+            source.recordsPerChunk = std::max<uint64_t>(1, source.chunkBytes / binaryInput.header().recordSize);
+        } else {
+            // 줄 중간에서 시작하거나 끝나면 다음 줄 시작으로 밀어, 범위를 이어 붙이면 모든 줄을 한 번씩 처리
+            const char* limit = reader.data() + inputEnd;
+            source.pos = CorpusReader::lineStart(reader.data(), limit, reader.data() + begin);
+            source.end = CorpusReader::lineStart(reader.data(), limit, reader.data() + end);
+            begin = (uint64_t)(source.pos - reader.data());
+            end = (uint64_t)(source.end - reader.data());
+        }
+        rangeBegin = begin;
+        rangeEnd = end;
+    }
+    if (binary && (options.variant == Variant::Kind::Jigsaw || options.variant == Variant::Kind::Killer)) {
+        fprintf(stderr, "직소/킬러 퍼즐은 텍스트 입력만 지원합니다: %s\n", options.inputPath);
+        return false;
+    }
+    const Variant& variant = options.variant == Variant::Kind::Diagonal ? Variant::diagonal()
+        : options.variant == Variant::Kind::Windoku ? Variant::windoku() : Variant::classic();
+
+    // 체크포인트가 있으면 그 위치부터 이어서 처리 (출력은 체크포인트 위치 뒤를 잘라냄)
+    Checkpoint::State resume;
+    bool resuming = false;
+    uint64_t fingerprint = (uint64_t)options.mode | (uint64_t)options.outputFormat << 4 | (uint64_t)options.variant << 8
+        | (uint64_t)options.useBacktrack << 12 | (uint64_t)(options.tracePath != nullptr) << 13 | (uint64_t)options.traceJson << 14
+        | (uint64_t)options.verify << 15 | (uint64_t)(options.verify && options.verifyLogPath) << 16
+        | (uint64_t)(options.cacheBytes > 0) << 17 | (uint64_t)options.cacheCanonical << 18;
+    if (options.checkpointPath) {
+        if (in || !options.outputPath || (options.outputFormat == Format::Binary && options.writeIndex)) {
+            fprintf(stderr, "체크포인트는 파일 입력과 파일 출력에서만 쓸 수 있고 --index와는 함께 쓸 수 없습니다\n");
+            return false;
+        }
+        resuming = Checkpoint::load(options.checkpointPath, resume);
+        // 다른 범위로 이어 하면 원래 조각 밖의 줄이 출력에 섞이므로 범위도 같아야 함
+        if (resuming && (resume.inputSize != reader.size() || resume.options != fingerprint
+            || resume.rangeBegin != rangeBegin || resume.rangeEnd != rangeEnd
+            || resume.inputOffset < rangeBegin || resume.inputOffset > rangeEnd)) {
+            fprintf(stderr, "체크포인트가 이 입력이나 옵션과 맞지 않습니다: %s\n", options.checkpointPath);
+            return false;
+        }
+    }
+
+    FILE* out = options.outputPath ? fopen(options.outputPath, resuming ? "r+b" : "wb") : stdout;
+    if (!out) {
+        fprintf(stderr, "출력 파일을 열 수 없습니다: %s\n", options.outputPath);
+        return false;
+    }
+    FILE* traceOut = nullptr;
+    if (options.tracePath) {
+        traceOut = fopen(options.tracePath, resuming ? "r+b" : "wb");
+        if (!traceOut) {
+            fprintf(stderr, "기록 파일을 열 수 없습니다: %s\n", options.tracePath);
+            if (out != stdout) fclose(out);
+            return false;
+        }
+    }
+    // 불일치 기록도 출력처럼 체크포인트 위치 뒤를 잘라내고 이어 씀
+    FILE* verifyLog = stderr;
+    if (options.verify && options.verifyLogPath) {
+        verifyLog = fopen(options.verifyLogPath, resuming ? "r+b" : "wb");
+        if (!verifyLog) {
+            fprintf(stderr, "검증 기록 파일을 열 수 없습니다: %s\n", options.verifyLogPath);
+            if (traceOut) fclose(traceOut);
+            if (out != stdout) fclose(out);
+            return false;
+        }
+    }
+    std::unique_ptr<FILE, int (*)(FILE*)> verifyLogFile(verifyLog != stderr ? verifyLog : nullptr, fclose);
+    if (resuming && (!Checkpoint::truncate(out, resume.outputOffset)
+        || (traceOut && !Checkpoint::truncate(traceOut, resume.traceOffset))
+        || (verifyLogFile && !Checkpoint::truncate(verifyLog, resume.verifyLogOffset)))) {
+        fprintf(stderr, "출력 파일이 체크포인트보다 짧아 이어서 처리할 수 없습니다: %s\n", options.outputPath);
+        if (traceOut) fclose(traceOut);
+        fclose(out);
+        return false;
+    }
+    if (resuming) {
+        if (binary) source.nextRecord = resume.inputOffset;
+        else source.pos = reader.data() + resume.inputOffset;
+        stats.total = resume.total;
+        stats.solved = resume.solved;
+        stats.unsolved = resume.unsolved;
+        stats.invalid = resume.invalid;
+        stats.traceRecords = resume.traceRecords;
+        stats.verified = resume.verified;
+        stats.mismatches = resume.mismatches;
+        stats.resumed = resume.total;
+    }
+#ifdef _WIN32
+    if (out == stdout && options.outputFormat == Format::Binary) _setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+    Context ctx = { options, binary ? &binaryInput : nullptr,
+        (uint16_t)(options.mode == Mode::Solve ? BinaryFormat::HAS_GIVENS : 0) };
+    bool seekable = out != stdout || fseek(out, 0, SEEK_CUR) == 0;
+    bool writeIndex = options.outputFormat == Format::Binary && options.writeIndex && seekable;
+    BinaryFormat::Header header;
+    header.flags = (uint16_t)(ctx.outputFlags | (writeIndex ? BinaryFormat::HAS_INDEX : 0));
+    header.recordSize = (uint32_t)BinaryFormat::recordSize(ctx.outputFlags);
+    header.recordCount = BinaryFormat::UNKNOWN_COUNT;
+
+    bool ok = true;
+    uint64_t outputBytes = resuming ? resume.outputOffset : 0;
+    uint64_t traceBytes = resuming ? resume.traceOffset : 0;
+    uint64_t verifyLogBytes = resuming ? resume.verifyLogOffset : 0;
+    if (options.outputFormat == Format::Binary && !resuming) {
+        unsigned char buf[BinaryFormat::HEADER_SIZE];
+        BinaryFormat::writeHeader(header, buf);
+        if (fwrite(buf, 1, sizeof(buf), out) != sizeof(buf)) ok = false;
+        outputBytes += sizeof(buf);
+    }
+    if (traceOut && !options.traceJson && !resuming) {
+        unsigned char buf[Trace::HEADER_SIZE];
+        Trace::writeHeader(buf);
+        if (fwrite(buf, 1, sizeof(buf), traceOut) != sizeof(buf)) ok = false;
+        traceBytes += sizeof(buf);
+    }
+
+    std::unique_ptr<SolutionCache> cache;
+    SolutionCache::Stats cacheBase;     // 체크포인트에서 이어 받은 카운터
+    if (resuming) {
+        cacheBase.hits = resume.cacheHits;
+        cacheBase.misses = resume.cacheMisses;
+        cacheBase.evictions = resume.cacheEvictions;
+    }
+    if (options.cacheBytes > 0) {
+        cache.reset(new SolutionCache(options.cacheBytes,
+            options.cacheCanonical ? SolutionCache::KeyMode::Canonical : SolutionCache::KeyMode::Raw));
+    }
+
+    SolverPool::Config config;
+    config.variant = &variant;
+    config.useBacktrack = options.useBacktrack;
+    config.cache = cache.get();
+    config.traceCapacity = traceOut ? options.traceCapacity : 0;
+    SolverPool pool(threads, config);
+
+    // 워커별 지표를 합쳐 주기적으로 stderr와 Prometheus 파일에 보고
+    auto started = std::chrono::steady_clock::now();
+    auto collect = [&](Telemetry::Snapshot& snap) {
+        for (int i = 0; i < pool.size(); i++) snap.add(pool.context(i).metrics);
+    };
+    uint64_t lastTotal = 0;
+    double lastElapsed = 0;
+    Telemetry::Reporter reporter(options.reportInterval, [&](double elapsed) {
+        Telemetry::Snapshot snap;
+        collect(snap);
+        std::string line;
+        Telemetry::formatReport(snap, elapsed, (snap.total() - lastTotal) / (elapsed - lastElapsed), line);
+        fprintf(stderr, "%s\n", line.c_str());
+        if (options.metricsPath) Telemetry::writePrometheus(snap, elapsed, options.metricsPath);
+        lastTotal = snap.total();
+        lastElapsed = elapsed;
+    });
+
+    // 리더 -> 작업자 -> 작성기. 칸 번호만 큐로 오가고, 앞서가는 청크는 칸 수(window)로 제한됨
+    const size_t window = (size_t)threads * 2;
+    std::vector<Slot> slots(window);
+    BoundedQueue<int> freeSlots(window);
+    BoundedQueue<int> jobQueue(window);
+    BoundedQueue<int> doneQueue(window);
+    for (size_t i = 0; i < window; i++) freeSlots.push((int)i);
+
+    std::thread readerThread([&]() {
+        int s;
+        for (uint64_t seq = 0; freeSlots.pop(s); seq++) {
+            if (!source.next(slots[s])) break;
+            slots[s].seq = seq;
+            jobQueue.push(s);
+        }
+        jobQueue.close();
+    });
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&]() {
+            int s;
+            while (jobQueue.pop(s)) {
+                Slot& slot = slots[s];
+                SolverPool::Lease sc(pool);
+                Trace::Recorder* recorder = sc->recorder.get();
+                Trace::setRecorder(recorder);
+                if (binary) processBinary(ctx, slot.job, *sc, slot.result);
+                else processText(ctx, slot.job, *sc, slot.result);
+                if (recorder) {
+                    recorder->copyTo(slot.result.trace);
+                    slot.result.stats.traceDropped = recorder->dropped();
+                    recorder->clear();
+                }
+                Trace::setRecorder(nullptr);
+                doneQueue.push(s);
+            }
+        });
+    }
+
+    bool writeOk = true;
+    std::vector<uint64_t> index;
+    std::thread writerThread([&]() {
+        // 끝난 순서대로 받아 입력 순서로 씀. 진행 중인 칸은 window개 이하라 seq % window가 겹치지 않음
+        std::vector<int> pending(window, -1);
+        std::string traceBuf;
+        uint64_t written = 0;
+        uint64_t lineBase = resuming ? resume.lineBase : options.lineBase;
+        auto nextCheckpoint = std::chrono::steady_clock::now() + std::chrono::seconds(CHECKPOINT_SECONDS);
+        int s;
+        while (doneQueue.pop(s)) {
+            pending[slots[s].seq % window] = s;
+            while (pending[written % window] >= 0) {
+                int ready = pending[written % window];
+                pending[written % window] = -1;
+                Slot& slot = slots[ready];
+                ChunkResult& r = slot.result;
+                if (fwrite(r.output.data(), 1, r.output.size(), out) != r.output.size()) writeOk = false;
+                outputBytes += r.output.size();
+                if (writeIndex) {
+                    for (uint64_t line : r.lines) index.push_back(binary ? line : lineBase + line);
+                }
+                if (traceOut) {
+                    // 텍스트 입력의 줄 번호는 청크 기준이므로 여기서 전체 기준으로 바꿈
+                    traceBuf.clear();
+                    for (Trace::Record rec : r.trace) {
+                        if (!binary) rec.puzzle += (uint32_t)lineBase;
+                        if (options.traceJson) Trace::appendJson(rec, traceBuf);
+                        else Trace::appendBinary(rec, traceBuf);
+                    }
+                    if (fwrite(traceBuf.data(), 1, traceBuf.size(), traceOut) != traceBuf.size()) writeOk = false;
+                    traceBytes += traceBuf.size();
+                    stats.traceRecords += r.trace.size();
+                    stats.traceDropped += r.stats.traceDropped;
+                }
+                for (const Verifier::Mismatch& m : r.mismatches) {
+                    // 줄 번호는 1부터 (바이너리 입력은 원본 줄 번호나 레코드 번호)
+                    int n = fprintf(verifyLog, "줄 %llu\t%s\t%.81s\t%.81s\t%.81s\n",
+                        (unsigned long long)((binary ? m.line : lineBase + m.line) + 1),
+                        Verifier::kindName(m.kind), m.puzzle, m.output, m.reference);
+                    if (n > 0) verifyLogBytes += (uint64_t)n;
+                }
+                lineBase += r.lineCount;
+                stats.verified += r.stats.verified;
+                stats.mismatches += r.stats.mismatches;
+                stats.total += r.stats.total;
+                stats.solved += r.stats.solved;
+                stats.unsolved += r.stats.unsolved;
+                stats.invalid += r.stats.invalid;
+                if (!in) reader.release(slot.job.begin, slot.job.end);
+                if (options.checkpointPath && writeOk && std::chrono::steady_clock::now() >= nextCheckpoint) {
+                    // 출력을 디스크에 내린 뒤에만 그 위치를 체크포인트에 적음
+                    Checkpoint::State cp;
+                    cp.inputSize = reader.size();
+                    cp.options = fingerprint;
+                    cp.rangeBegin = rangeBegin;
+                    cp.rangeEnd = rangeEnd;
+                    cp.inputOffset = binary ? slot.job.lastRecord : (uint64_t)(slot.job.end - reader.data());
+                    cp.lineBase = lineBase;
+                    cp.outputOffset = outputBytes;
+                    cp.traceOffset = traceBytes;
+                    cp.total = stats.total;
+                    cp.solved = stats.solved;
+                    cp.unsolved = stats.unsolved;
+                    cp.invalid = stats.invalid;
+                    cp.traceRecords = stats.traceRecords;
+                    cp.verifyLogOffset = verifyLogBytes;
+                    cp.verified = stats.verified;
+                    cp.mismatches = stats.mismatches;
+                    if (cache) {
+                        // 캐시는 빈 채로 다시 시작하므로 카운터만 이어 붙임 (작업자가 앞서 처리한 청크도 들어가 근사값)
+                        SolutionCache::Stats cs = cache->getStats();
+                        cp.cacheHits = cacheBase.hits + cs.hits;
+                        cp.cacheMisses = cacheBase.misses + cs.misses;
+                        cp.cacheEvictions = cacheBase.evictions + cs.evictions;
+                    }
+                    if (!Checkpoint::sync(out) || (traceOut && !Checkpoint::sync(traceOut))
+                        || (verifyLogFile && !Checkpoint::sync(verifyLog))
+                        || !Checkpoint::save(options.checkpointPath, cp)) {
+                        fprintf(stderr, "체크포인트를 쓸 수 없습니다: %s\n", options.checkpointPath);
+                        writeOk = false;
+                    }
+                    nextCheckpoint = std::chrono::steady_clock::now() + std::chrono::seconds(CHECKPOINT_SECONDS);
+                }
+                // 용량은 남겨 두고 비움 (다음 청크가 이 칸을 씀)
+                r.output.clear();
+                r.lines.clear();
+                r.trace.clear();
+                r.mismatches.clear();
+                r.lineCount = 0;
+                r.stats = Stats();
+                written++;
+                freeSlots.push(ready);
+            }
+        }
+        stats.lines = lineBase - options.lineBase;
+    });
+
+    readerThread.join();
+    for (auto& w : workers) w.join();
+    doneQueue.close();
+    writerThread.join();
+    reporter.stop();
+    if (!writeOk) ok = false;
+
+    Telemetry::Snapshot snap;
+    collect(snap);
+    stats.backtracks = snap.counters[Telemetry::Backtracked];
+    stats.latencyP50 = snap.percentile(0.5);
+    stats.latencyP99 = snap.percentile(0.99);
+    stats.latencyP999 = snap.percentile(0.999);
+    stats.latencyMax = snap.max;
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    if (options.metricsPath && !Telemetry::writePrometheus(snap, elapsed, options.metricsPath)) {
+        fprintf(stderr, "지표 파일을 쓸 수 없습니다: %s\n", options.metricsPath);
+        ok = false;
+    }
+    if (source.error) {
+        fprintf(stderr, "입력을 읽는 중 오류가 발생했습니다: %s\n", options.inputPath);
+        ok = false;
+    }
+    if (cache) {
+        SolutionCache::Stats cs = cache->getStats();
+        stats.cacheHits = cacheBase.hits + cs.hits;
+        stats.cacheMisses = cacheBase.misses + cs.misses;
+        stats.cacheEvictions = cacheBase.evictions + cs.evictions;
+    }
+
+    // 레코드 수와 인덱스 위치를 헤더에 기록 (되감을 수 없는 스트림은 UNKNOWN_COUNT 유지)
+    if (options.outputFormat == Format::Binary && seekable) {
+        header.recordCount = stats.total - stats.invalid;
+        if (writeIndex) {
+            header.indexOffset = BinaryFormat::HEADER_SIZE + header.recordCount * header.recordSize;
+            unsigned char buf[8];
+            for (uint64_t line : index) {
+                BinaryFormat::writeU64(line, buf);
+                if (fwrite(buf, 1, 8, out) != 8) ok = false;
+            }
+        }
+        unsigned char buf[BinaryFormat::HEADER_SIZE];
+        BinaryFormat::writeHeader(header, buf);
+        if (fseek(out, 0, SEEK_SET) != 0 || fwrite(buf, 1, sizeof(buf), out) != sizeof(buf)) ok = false;
+    }
+
+    if (traceOut && fclose(traceOut) != 0) ok = false;
+    if (out != stdout) { if (fclose(out) != 0) ok = false; }
+    else fflush(out);
+    // 끝까지 처리했으면 다음 실행이 이어 하지 않도록 지움
+    if (ok && options.checkpointPath) remove(options.checkpointPath);
+    return ok;
+}
+
+} // namespace Batch
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "sudoku_grid.h"
+#include "variant.h"
+#include "verifier.h"
+
+namespace Batch {
+    enum class Mode {
+        Solve,      // 풀어서 해답 출력
+        Convert,    // 풀지 않고 형식만 변환
+        Canonical,  // 대칭 표준형으로 변환 (중복 제거용)
+        Rate,       // 난이도 평가 (텍스트 출력: 퍼즐, 점수, 단계)
+        Minimize,   // 불필요한 단서 제거 (유일해가 아니면 원본 그대로)
+    };
+
+    enum class Format {
+        Text,       // 한 줄에 81글자
+        Binary,     // binary_format.h
+    };
+
+    struct Options {
+        const char* inputPath = nullptr;    // 텍스트/바이너리는 자동 판별
+        const char* outputPath = nullptr;   // nullptr이면 stdout
+        int threads = 0;                    // 0이면 코어 수
+        bool useBacktrack = false;
+        Mode mode = Mode::Solve;
+        Variant::Kind variant = Variant::Kind::Classic;  // Jigsaw/Killer는 줄마다 퍼즐 뒤에 배치 (README 참고)
+        Format outputFormat = Format::Text;
+        bool writeIndex = false;            // 바이너리 출력에 원본 줄 번호 인덱스 추가
+        size_t cacheBytes = 0;              // 해답 캐시 용량 (0이면 사용 안 함)
+        bool cacheCanonical = true;         // 캐시 키: 표준형 / 원본 그대로
+        const char* tracePath = nullptr;    // 풀이 단계 기록 (SUDOKU_ENABLE_TRACE 빌드)
+        bool traceJson = false;             // JSON Lines / 바이너리
+        size_t traceCapacity = 1 << 20;     // 스레드당 링 버퍼 레코드 수 (청크마다 비움)
+        const char* metricsPath = nullptr;  // Prometheus 텍스트 파일 (보고할 때마다, 끝날 때 갱신)
+        double reportInterval = 0;          // 초, 0이면 주기 보고 안 함 (stderr)
+        const char* checkpointPath = nullptr;   // 있으면 이어서 처리, 끝까지 마치면 지움 (파일 입출력만)
+        uint64_t rangeBegin = 0;            // 처리할 입력 범위 (텍스트: 바이트, 둘 다 다음 줄 시작으로 맞춤 / 바이너리: 레코드)
+        uint64_t rangeEnd = ~0ull;
+        uint64_t lineBase = 0;              // 텍스트 범위 앞의 줄 수 (인덱스, 기록, 불일치 보고의 줄 번호가 파일 기준이 되게)
+        bool verify = false;                // 풀이 모드: 내놓은 해를 모두 확인하고 표본은 기준 엔진과 비교
+        double verifySample = 1.0;          // 기준 엔진으로 다시 풀 비율 (0-1, 퍼즐 해시로 정함)
+        Verifier::Reference verifyReference = Verifier::Reference::Search;
+        const char* verifyLogPath = nullptr;    // 불일치 기록 (nullptr이면 stderr)
+    };
+
+    struct Stats {
+        size_t total = 0;
+        size_t solved = 0;
+        size_t unsolved = 0;
+        size_t invalid = 0;
+        uint64_t cacheHits = 0;
+        uint64_t cacheMisses = 0;
+        uint64_t cacheEvictions = 0;
+        uint64_t traceRecords = 0;
+        uint64_t traceDropped = 0;          // 링 버퍼가 넘쳐 잃은 레코드
+        uint64_t backtracks = 0;            // 백트래킹으로 넘어간 퍼즐
+        uint64_t lines = 0;                 // 읽은 줄 수 (건너뛴 줄 포함, lineBase 제외)
+        uint64_t verified = 0;              // 기준 엔진과 비교한 퍼즐
+        uint64_t mismatches = 0;            // 잘못된 해와 기준 엔진과의 불일치
+        uint64_t resumed = 0;               // 체크포인트에서 이어 받은 퍼즐 (total에 포함)
+        uint64_t latencyP50 = 0;            // 풀이 지연 (ns)
+        uint64_t latencyP99 = 0;
+        uint64_t latencyP999 = 0;
+        uint64_t latencyMax = 0;
+    };
+
+    // 퍼즐 파일을 병렬로 처리해 입력 순서대로 출력
+    bool solveFile(const Options& options, Stats& stats);
+
+    // 그리드를 81글자로 기록 (빈칸 = '.')
+    void formatGrid(const SudokuGrid& grid, char* out);
+}
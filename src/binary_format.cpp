@@ -0,0 +1,129 @@
+#include "binary_format.h"
+#include <cstring>
+
+namespace BinaryFormat {
+
+namespace {
+
+const unsigned char MAGIC[4] = { 'S', 'D', 'K', 'B' };
+
+void writeU16(uint16_t value, unsigned char* out) {
+    out[0] = (unsigned char)value;
+    out[1] = (unsigned char)(value >> 8);
+}
+
+void writeU32(uint32_t value, unsigned char* out) {
+    for (int i = 0; i < 4; i++) out[i] = (unsigned char)(value >> (8 * i));
+}
+
+uint16_t readU16(const unsigned char* in) {
+    return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+uint32_t readU32(const unsigned char* in) {
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; i--) value = (value << 8) | in[i];
+    return value;
+}
+
+} // namespace
+
+void writeU64(uint64_t value, unsigned char* out) {
+    for (int i = 0; i < 8; i++) out[i] = (unsigned char)(value >> (8 * i));
+}
+
+uint64_t readU64(const unsigned char* in) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; i--) value = (value << 8) | in[i];
+    return value;
+}
+
+size_t recordSize(uint16_t flags) {
+    return CELL_BYTES + ((flags & HAS_GIVENS) ? GIVENS_BYTES : 0);
+}
+
+bool isBinary(const char* data, size_t size) {
+    return size >= HEADER_SIZE && memcmp(data, MAGIC, 4) == 0;
+}
+
+void writeHeader(const Header& header, unsigned char* out) {
+    memset(out, 0, HEADER_SIZE);
+    memcpy(out, MAGIC, 4);
+    writeU16(header.version, out + 4);
+    writeU16(header.flags, out + 6);
+    writeU32(header.recordSize, out + 8);
+    writeU64(header.recordCount, out + 16);
+    writeU64(header.indexOffset, out + 24);
+}
+
+bool readHeader(const unsigned char* in, size_t size, Header& header) {
+    if (!isBinary((const char*)in, size)) return false;
+    header.version = readU16(in + 4);
+    header.flags = readU16(in + 6);
+    header.recordSize = readU32(in + 8);
+    header.recordCount = readU64(in + 16);
+    header.indexOffset = readU64(in + 24);
+    if (header.version != VERSION || header.recordSize != recordSize(header.flags)) return false;
+
+    uint64_t available = (size - HEADER_SIZE) / header.recordSize;
+    if (header.recordCount == UNKNOWN_COUNT) {
+        header.recordCount = available;
+        header.flags = (uint16_t)(header.flags & ~HAS_INDEX);
+    }
+    if (header.recordCount > available) return false;
+    if (header.flags & HAS_INDEX) {
+        if (header.indexOffset > size || (size - header.indexOffset) / 8 < header.recordCount) return false;
+    }
+    return true;
+}
+
+void encode(const SudokuGrid& grid, uint16_t flags, unsigned char* out) {
+    memset(out, 0, recordSize(flags));
+    for (int idx = 0; idx < 81; idx++) {
+        int val = grid.getValue(idx / 9, idx % 9);
+        out[idx >> 1] |= (unsigned char)(val << ((idx & 1) * 4));
+    }
+    if (flags & HAS_GIVENS) {
+        unsigned char* givens = out + CELL_BYTES;
+        for (int idx = 0; idx < 81; idx++) {
+            if (grid.isOriginal[idx / 9][idx % 9]) givens[idx >> 3] |= (unsigned char)(1 << (idx & 7));
+        }
+    }
+}
+
+bool decode(const unsigned char* in, uint16_t flags, SudokuGrid& grid) {
+    grid.reset();
+    const unsigned char* givens = (flags & HAS_GIVENS) ? in + CELL_BYTES : nullptr;
+    for (int idx = 0; idx < 81; idx++) {
+        int num = (in[idx >> 1] >> ((idx & 1) * 4)) & 0xF;
+        if (num == 0) continue;
+        int row = idx / 9, col = idx % 9;
+        if (num > 9 || !grid.isValidMove(row, col, num)) return false;
+        grid.setCell(row, col, num);
+        grid.isOriginal[row][col] = givens ? ((givens[idx >> 3] >> (idx & 7)) & 1) != 0 : true;
+    }
+    return true;
+}
+
+bool Reader::open(const char* path) {
+    if (!file.open(path)) return false;
+    return attach(file.data(), file.size());
+}
+
+bool Reader::attach(const char* data, size_t size) {
+    const unsigned char* base = (const unsigned char*)data;
+    if (!readHeader(base, size, hdr)) return false;
+    records = base + HEADER_SIZE;
+    index = (hdr.flags & HAS_INDEX) ? base + hdr.indexOffset : nullptr;
+    return true;
+}
+
+bool Reader::decode(uint64_t i, SudokuGrid& grid) const {
+    return BinaryFormat::decode(record(i), hdr.flags, grid);
+}
+
+uint64_t Reader::sourceLine(uint64_t i) const {
+    return index ? readU64(index + i * 8) : i;
+}
+
+} // namespace BinaryFormat
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "corpus_reader.h"
+#include "sudoku_grid.h"
+
+// 압축 바이너리 퍼즐/해답 형식
+//   헤더 32바이트: "SDKB", 버전, 플래그, 레코드 크기, 레코드 수, 인덱스 위치 (리틀 엔디언)
+//   레코드: 칸당 4비트 41바이트 (0 = 빈칸) + 선택적으로 주어진 칸 비트마스크 11바이트
+//   인덱스: 선택적, 레코드마다 원본 텍스트의 줄 번호 (uint64)
+namespace BinaryFormat {
+    const size_t HEADER_SIZE = 32;
+    const size_t CELL_BYTES = 41;
+    const size_t GIVENS_BYTES = 11;
+    const uint16_t VERSION = 1;
+    const uint64_t UNKNOWN_COUNT = ~0ull;   // 스트림 출력: 파일 끝까지
+
+    enum Flags : uint16_t {
+        HAS_GIVENS = 1,
+        HAS_INDEX = 2,
+    };
+
+    struct Header {
+        uint16_t version = VERSION;
+        uint16_t flags = 0;
+        uint32_t recordSize = CELL_BYTES;
+        uint64_t recordCount = 0;
+        uint64_t indexOffset = 0;
+    };
+
+    size_t recordSize(uint16_t flags);
+    bool isBinary(const char* data, size_t size);
+
+    void writeHeader(const Header& header, unsigned char* out);
+    bool readHeader(const unsigned char* in, size_t size, Header& header);
+
+    void encode(const SudokuGrid& grid, uint16_t flags, unsigned char* out);
+    bool decode(const unsigned char* in, uint16_t flags, SudokuGrid& grid);
+
+    void writeU64(uint64_t value, unsigned char* out);
+    uint64_t readU64(const unsigned char* in);
+
+    // 매핑된 바이너리 파일의 레코드 접근
+    class Reader {
+    public:
+        bool open(const char* path);
+        bool attach(const char* data, size_t size);
+
+        const Header& header() const { return hdr; }
+        uint64_t count() const { return hdr.recordCount; }
+        const unsigned char* record(uint64_t i) const { return records + i * hdr.recordSize; }
+        bool decode(uint64_t i, SudokuGrid& grid) const;
+        uint64_t sourceLine(uint64_t i) const;
+
+    private:
+        CorpusReader file;
+        Header hdr;
+        const unsigned char* records = nullptr;
+        const unsigned char* index = nullptr;
+    };
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <thread>
+
+// 고정 용량 다중 생산자/다중 소비자 큐 (락 없음, 칸마다 순번을 두는 링 버퍼).
+// 꽉 차면 push가, 비면 pop이 점점 길게 쉬며 기다림. close() 뒤 pop은 남은 것을 다 꺼내면 false
+template <typename T>
+class BoundedQueue {
+public:
+    // capacity는 2의 거듭제곱으로 올림
+    explicit BoundedQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        cells.reset(new Cell[size]);
+        for (size_t i = 0; i < size; i++) cells[i].seq.store(i, std::memory_order_relaxed);
+        mask = size - 1;
+    }
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    bool tryPush(const T& value) {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.seq.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // 가득 참
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPop(T& value) {
+        size_t pos = head.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.seq.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = cell.value;
+                    cell.seq.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // 비어 있음
+            } else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void push(const T& value) {
+        Backoff backoff;
+        while (!tryPush(value)) backoff.pause();
+    }
+
+    bool pop(T& value) {
+        Backoff backoff;
+        for (;;) {
+            if (tryPop(value)) return true;
+            // close() 전에 넣은 것은 close()를 본 뒤 한 번 더 꺼내면 보임
+            if (closed.load(std::memory_order_acquire)) return tryPop(value);
+            backoff.pause();
+        }
+    }
+
+    void close() { closed.store(true, std::memory_order_release); }
+
+private:
+    struct Cell {
+        std::atomic<size_t> seq;
+        T value;
+    };
+
+    // 잠깐 돌다가 양보하고, 그래도 안 되면 잠듦 (청크 하나 푸는 데 수 ms가 걸려 깨어나는 지연은 무시할 만함)
+    struct Backoff {
+        int spins = 0;
+        void pause() {
+            if (spins < 64) spins++;
+            else if (spins < 128) { spins++; std::this_thread::yield(); }
+            else std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(64) std::atomic<size_t> tail{0};    // 생산자와 소비자 위치를 다른 캐시 줄에
+    alignas(64) std::atomic<size_t> head{0};
+    std::atomic<bool> closed{false};
+};
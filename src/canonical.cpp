@@ -0,0 +1,281 @@
+#include "canonical.h"
+#include <algorithm>
+#include <vector>
+
+namespace Canonical {
+
+namespace {
+
+const int COL_PERMS = 1296;     // 스택 순열 6 × 스택 내 열 순열 6^3
+const uint8_t PERM3[6][3] = { {0,1,2}, {0,2,1}, {1,0,2}, {1,2,0}, {2,0,1}, {2,1,0} };
+
+struct Candidate {
+    uint8_t transpose;
+    uint16_t colPerm;
+    uint8_t usedBands;
+    uint8_t nextLabel;
+    uint8_t rows[9];
+    uint8_t digits[10];
+};
+
+const std::array<std::array<uint8_t, 9>, COL_PERMS>& colPerms() {
+    static const std::array<std::array<uint8_t, 9>, COL_PERMS> table = []() {
+        std::array<std::array<uint8_t, 9>, COL_PERMS> t;
+        int n = 0;
+        for (int s = 0; s < 6; s++)
+            for (int a = 0; a < 6; a++)
+                for (int b = 0; b < 6; b++)
+                    for (int c = 0; c < 6; c++) {
+                        const int inner[3] = { a, b, c };
+                        for (int k = 0; k < 3; k++) {
+                            int stack = PERM3[s][k];
+                            for (int m = 0; m < 3; m++)
+                                t[n][k * 3 + m] = (uint8_t)(stack * 3 + PERM3[inner[k]][m]);
+                        }
+                        n++;
+                    }
+        return t;
+    }();
+    return table;
+}
+
+// 후보의 다음 행을 표준형으로 옮기며 best와 비교
+// 반환: -1 더 작음(best 갱신), 0 같음, 1 더 큼(중단)
+int evalRow(const uint8_t* src, const uint8_t* perm, int row, Candidate& c, uint8_t* best, bool first) {
+    int cmp = first ? -1 : 0;
+    const uint8_t* line = src + row * 9;
+    for (int j = 0; j < 9; j++) {
+        int d = line[perm[j]];
+        if (d && !c.digits[d]) c.digits[d] = c.nextLabel++;
+        int v = c.digits[d];
+        if (cmp == 0) {
+            if (v > best[j]) return 1;
+            if (v < best[j]) cmp = -1;
+        }
+        if (cmp < 0) best[j] = (uint8_t)v;
+    }
+    return cmp;
+}
+
+// 첫 행으로 만들 수 있는 최소 패턴 (주어진 칸 = 1, 앞쪽 칸이 상위 비트)
+// 스택을 주어진 칸 수 오름차순으로, 스택 안에서는 빈칸을 앞으로
+int bestPattern(const uint8_t* line) {
+    int counts[3];
+    for (int s = 0; s < 3; s++) counts[s] = (line[s * 3] != 0) + (line[s * 3 + 1] != 0) + (line[s * 3 + 2] != 0);
+    if (counts[0] > counts[1]) std::swap(counts[0], counts[1]);
+    if (counts[1] > counts[2]) std::swap(counts[1], counts[2]);
+    if (counts[0] > counts[1]) std::swap(counts[0], counts[1]);
+    int pattern = 0;
+    for (int s = 0; s < 3; s++) pattern = (pattern << 3) | ((1 << counts[s]) - 1);
+    return pattern;
+}
+
+// 행을 최소 패턴으로 만드는 열 순열 번호만 생성
+int patternPerms(const uint8_t* line, uint16_t* out) {
+    int counts[3];
+    for (int s = 0; s < 3; s++) counts[s] = (line[s * 3] != 0) + (line[s * 3 + 1] != 0) + (line[s * 3 + 2] != 0);
+    int n = 0;
+    for (int s = 0; s < 6; s++) {
+        if (counts[PERM3[s][0]] > counts[PERM3[s][1]] || counts[PERM3[s][1]] > counts[PERM3[s][2]]) continue;
+        int inner[3][6], innerCount[3] = { 0, 0, 0 };
+        for (int k = 0; k < 3; k++) {
+            const uint8_t* cells = line + PERM3[s][k] * 3;
+            for (int i = 0; i < 6; i++) {
+                bool a = cells[PERM3[i][0]] != 0, b = cells[PERM3[i][1]] != 0, c = cells[PERM3[i][2]] != 0;
+                if ((!a || b) && (!b || c)) inner[k][innerCount[k]++] = i;
+            }
+        }
+        for (int a = 0; a < innerCount[0]; a++)
+            for (int b = 0; b < innerCount[1]; b++)
+                for (int c = 0; c < innerCount[2]; c++)
+                    out[n++] = (uint16_t)(s * 216 + inner[0][a] * 36 + inner[1][b] * 6 + inner[2][c]);
+    }
+    return n;
+}
+
+// 완전히 빈 행/열끼리의 교환은 같은 결과를 내므로 오름차순 배치 하나만 남김
+bool canonicalPerm(const uint8_t* perm, int blankCols) {
+    for (int k = 0; k < 3; k++) {
+        for (int m = 0; m < 2; m++) {
+            int a = perm[k * 3 + m], b = perm[k * 3 + m + 1];
+            int c = m == 0 ? perm[k * 3 + 2] : -1;
+            if (((blankCols >> a) & 1) && ((blankCols >> b) & 1) && a > b) return false;
+            if (c >= 0 && ((blankCols >> a) & 1) && ((blankCols >> c) & 1) && a > c) return false;
+        }
+    }
+    for (int k = 0; k < 2; k++) {
+        for (int k2 = k + 1; k2 < 3; k2++) {
+            int s1 = perm[k * 3] / 3, s2 = perm[k2 * 3] / 3;
+            bool blank1 = ((blankCols >> (s1 * 3)) & 7) == 7, blank2 = ((blankCols >> (s2 * 3)) & 7) == 7;
+            if (blank1 && blank2 && s1 > s2) return false;
+        }
+    }
+    return true;
+}
+
+bool redundantRow(int row, int usedRows, int blankRows) {
+    if (!((blankRows >> row) & 1)) return false;
+    int band = row / 3;
+    // 같은 밴드의 더 앞선 빈 행이 남아 있으면 중복
+    for (int r = band * 3; r < row; r++) {
+        if (((blankRows >> r) & 1) && !((usedRows >> r) & 1)) return true;
+    }
+    // 밴드 전체가 비었으면 더 앞선 빈 밴드가 남아 있을 때 중복
+    if (((blankRows >> (band * 3)) & 7) == 7 && !((usedRows >> (band * 3)) & 7)) {
+        for (int b = 0; b < band; b++) {
+            if (((blankRows >> (b * 3)) & 7) == 7 && !((usedRows >> (b * 3)) & 7)) return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+Form fromGrid(const SudokuGrid& grid) {
+    Form f;
+    for (int i = 0; i < 81; i++) f[i] = (uint8_t)grid.getValue(i / 9, i % 9);
+    return f;
+}
+
+bool toGrid(const Form& form, SudokuGrid& grid) {
+    grid.reset();
+    for (int i = 0; i < 81; i++) {
+        int num = form[i], row = i / 9, col = i % 9;
+        if (num == 0) continue;
+        if (num > 9 || !grid.isValidMove(row, col, num)) return false;
+        grid.setCell(row, col, num);
+        grid.isOriginal[row][col] = true;
+    }
+    return true;
+}
+
+Form canonicalize(const SudokuGrid& grid, Transform* transform) {
+    return canonicalize(fromGrid(grid), transform);
+}
+
+Form canonicalize(const Form& cells, Transform* transform) {
+    const auto& perms = colPerms();
+    uint8_t src[2][81];
+    int blankRows[2] = { 0x1FF, 0x1FF };
+    for (int i = 0; i < 9; i++)
+        for (int j = 0; j < 9; j++) {
+            src[0][i * 9 + j] = cells[i * 9 + j];
+            src[1][j * 9 + i] = cells[i * 9 + j];
+            if (cells[i * 9 + j]) {
+                blankRows[0] &= ~(1 << i);
+                blankRows[1] &= ~(1 << j);
+            }
+        }
+
+    // 배치마다 벡터를 재사용해 할당을 피함
+    thread_local std::vector<Candidate> cur, next;
+    cur.clear();
+    Form result;
+    uint8_t* best = result.data();
+
+    // 첫 행: 최소 패턴을 만들 수 있는 (전치, 행)과 그 패턴을 만드는 열 순열만
+    int minPattern = 0x1FF;
+    for (int t = 0; t < 2; t++)
+        for (int r = 0; r < 9; r++) minPattern = std::min(minPattern, bestPattern(src[t] + r * 9));
+
+    bool first = true;
+    for (int t = 0; t < 2; t++) {
+        for (int r = 0; r < 9; r++) {
+            if (bestPattern(src[t] + r * 9) != minPattern || redundantRow(r, 0, blankRows[t])) continue;
+            uint16_t rowPerms[COL_PERMS];
+            int permCount = patternPerms(src[t] + r * 9, rowPerms);
+            for (int i = 0; i < permCount; i++) {
+                int p = rowPerms[i];
+                if (!canonicalPerm(perms[p].data(), blankRows[1 - t])) continue;
+                Candidate c = {};
+                c.transpose = (uint8_t)t;
+                c.colPerm = (uint16_t)p;
+                c.usedBands = (uint8_t)(1 << (r / 3));
+                c.nextLabel = 1;
+                c.rows[0] = (uint8_t)r;
+                int cmp = evalRow(src[t], perms[p].data(), r, c, best, first);
+                first = false;
+                if (cmp < 0) cur.clear();
+                if (cmp <= 0) cur.push_back(c);
+            }
+        }
+    }
+
+    // 나머지 행: 같은 밴드의 남은 행, 또는 새 밴드의 첫 행
+    for (int k = 1; k < 9; k++) {
+        next.clear();
+        uint8_t* rowBest = best + k * 9;
+        first = true;
+        for (const Candidate& base : cur) {
+            int usedRows = 0;
+            for (int q = 0; q < k; q++) usedRows |= 1 << base.rows[q];
+            int options[9], count = 0;
+            if (k % 3 == 0) {
+                for (int b = 0; b < 3; b++) {
+                    if (base.usedBands & (1 << b)) continue;
+                    for (int m = 0; m < 3; m++) options[count++] = b * 3 + m;
+                }
+            } else {
+                int band = base.rows[k - k % 3] / 3;
+                for (int m = 0; m < 3; m++) {
+                    if (!(usedRows & (1 << (band * 3 + m)))) options[count++] = band * 3 + m;
+                }
+            }
+            for (int o = 0; o < count; o++) {
+                if (redundantRow(options[o], usedRows, blankRows[base.transpose])) continue;
+                Candidate c = base;
+                c.rows[k] = (uint8_t)options[o];
+                c.usedBands |= (uint8_t)(1 << (options[o] / 3));
+                int cmp = evalRow(src[c.transpose], perms[c.colPerm].data(), options[o], c, rowBest, first);
+                first = false;
+                if (cmp < 0) next.clear();
+                if (cmp <= 0) next.push_back(c);
+            }
+        }
+        cur.swap(next);
+    }
+
+    if (transform) {
+        const Candidate& c = cur.front();
+        transform->transpose = c.transpose != 0;
+        for (int i = 0; i < 9; i++) {
+            transform->rows[i] = c.rows[i];
+            transform->cols[i] = perms[c.colPerm][i];
+        }
+        // 퍼즐에 없는 숫자는 남은 번호를 오름차순으로 배정
+        int label = c.nextLabel;
+        for (int d = 0; d <= 9; d++) {
+            transform->digits[d] = c.digits[d];
+            if (d && !c.digits[d]) transform->digits[d] = (uint8_t)label++;
+        }
+    }
+    return result;
+}
+
+Form apply(const Form& cells, const Transform& transform) {
+    Form out;
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            int r = transform.rows[i], c = transform.cols[j];
+            int d = transform.transpose ? cells[c * 9 + r] : cells[r * 9 + c];
+            out[i * 9 + j] = transform.digits[d];
+        }
+    }
+    return out;
+}
+
+Form invert(const Form& canonical, const Transform& transform) {
+    uint8_t inverse[10];
+    for (int d = 0; d <= 9; d++) inverse[transform.digits[d]] = (uint8_t)d;
+    Form out;
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            int r = transform.rows[i], c = transform.cols[j];
+            int idx = transform.transpose ? c * 9 + r : r * 9 + c;
+            out[idx] = inverse[canonical[i * 9 + j]];
+        }
+    }
+    return out;
+}
+
+} // namespace Canonical
@@ -0,0 +1,26 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include "sudoku_grid.h"
+
+// 스도쿠 대칭군(밴드/스택/행/열 순열, 전치, 숫자 재배치) 아래 최소 사전순 표준형
+namespace Canonical {
+    typedef std::array<uint8_t, 81> Form;   // 행 우선, 0 = 빈칸
+
+    // 표준형[i][j] = digits[원본'[rows[i]][cols[j]]], 원본' = transpose ? 원본의 전치 : 원본
+    struct Transform {
+        bool transpose = false;
+        std::array<uint8_t, 9> rows;
+        std::array<uint8_t, 9> cols;
+        std::array<uint8_t, 10> digits;     // 원본 숫자 → 표준형 숫자 (전단사, 0 → 0)
+    };
+
+    Form fromGrid(const SudokuGrid& grid);
+    bool toGrid(const Form& form, SudokuGrid& grid);
+
+    Form canonicalize(const Form& cells, Transform* transform = nullptr);
+    Form canonicalize(const SudokuGrid& grid, Transform* transform = nullptr);
+
+    Form apply(const Form& cells, const Transform& transform);
+    Form invert(const Form& canonical, const Transform& transform);
+}
@@ -0,0 +1,89 @@
+#include "checkpoint.h"
+#include "binary_format.h"
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+namespace Checkpoint {
+
+namespace {
+
+const char MAGIC[4] = { 'S', 'D', 'K', 'C' };
+
+// 파일에 적는 순서
+uint64_t State::* const FIELDS[] = {
+    &State::inputSize, &State::options, &State::inputOffset, &State::lineBase,
+    &State::outputOffset, &State::traceOffset, &State::total, &State::solved,
+    &State::unsolved, &State::invalid, &State::traceRecords, &State::verifyLogOffset,
+    &State::verified, &State::mismatches, &State::cacheHits, &State::cacheMisses,
+    &State::cacheEvictions, &State::rangeBegin, &State::rangeEnd,
+};
+const int FIELD_COUNT = (int)(sizeof(FIELDS) / sizeof(FIELDS[0]));
+static_assert(8 + sizeof(FIELDS) / sizeof(FIELDS[0]) * 8 == FILE_SIZE, "체크포인트 크기");
+
+} // namespace
+
+bool load(const char* path, State& state) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    unsigned char buf[FILE_SIZE];
+    bool ok = fread(buf, 1, sizeof(buf), f) == sizeof(buf);
+    fclose(f);
+    if (!ok || memcmp(buf, MAGIC, 4) != 0) return false;
+    uint32_t version = (uint32_t)buf[4] | ((uint32_t)buf[5] << 8) | ((uint32_t)buf[6] << 16) | ((uint32_t)buf[7] << 24);
+    if (version != VERSION) return false;
+    for (int i = 0; i < FIELD_COUNT; i++) state.*FIELDS[i] = BinaryFormat::readU64(buf + 8 + i * 8);
+    return true;
+}
+
+bool save(const char* path, const State& state) {
+    unsigned char buf[FILE_SIZE];
+    memcpy(buf, MAGIC, 4);
+    for (int i = 0; i < 4; i++) buf[4 + i] = (unsigned char)(VERSION >> (8 * i));
+    for (int i = 0; i < FIELD_COUNT; i++) BinaryFormat::writeU64(state.*FIELDS[i], buf + 8 + i * 8);
+
+    std::string tmp = std::string(path) + ".tmp";
+    FILE* f = fopen(tmp.c_str(), "wb");
+    if (!f) return false;
+    bool ok = fwrite(buf, 1, sizeof(buf), f) == sizeof(buf) && sync(f);
+    if (fclose(f) != 0) ok = false;
+#ifdef _WIN32
+    if (ok) ok = MoveFileExA(tmp.c_str(), path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    if (ok) ok = rename(tmp.c_str(), path) == 0;
+#endif
+    return ok;
+}
+
+bool sync(FILE* f) {
+    if (fflush(f) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(f)) == 0;
+#else
+    return fsync(fileno(f)) == 0;
+#endif
+}
+
+bool truncate(FILE* f, uint64_t size) {
+    if (fflush(f) != 0) return false;
+#ifdef _WIN32
+    __int64 length = _filelengthi64(_fileno(f));
+    if (length < 0 || (uint64_t)length < size) return false;
+    return _chsize_s(_fileno(f), (__int64)size) == 0 && _fseeki64(f, 0, SEEK_END) == 0;
+#else
+    struct stat st;
+    if (fstat(fileno(f), &st) != 0 || (uint64_t)st.st_size < size) return false;
+    return ftruncate(fileno(f), (off_t)size) == 0 && fseeko(f, 0, SEEK_END) == 0;
+#endif
+}
+
+} // namespace Checkpoint
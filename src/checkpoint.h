@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+// 긴 배치 작업의 체크포인트 (중단 뒤 이어서 처리)
+//   "SDKC", 버전 uint32, 이후 uint64 필드 (리틀 엔디언, 모두 160바이트)
+// 출력과 기록 파일을 디스크에 내린 뒤에만 그 위치를 적으므로, 이어 할 때 그 위치 뒤를 잘라내면
+// 중단 직전에 반쯤 쓴 부분이 남지 않음
+namespace Checkpoint {
+    const size_t FILE_SIZE = 160;
+    const uint32_t VERSION = 3;    // 2: 검증 카운터, 검증 기록 위치, 캐시 카운터 추가. 3: 입력 범위 추가
+
+    struct State {
+        uint64_t inputSize = 0;     // 다른 입력으로 이어 하지 않도록 확인
+        uint64_t options = 0;       // 출력에 영향을 주는 옵션 (Batch가 정함)
+        uint64_t inputOffset = 0;   // 텍스트: 처리한 바이트, 바이너리: 처리한 레코드
+        uint64_t rangeBegin = 0;    // --range (줄 시작에 맞춘 값, 단위는 inputOffset과 같음)
+        uint64_t rangeEnd = 0;
+        uint64_t lineBase = 0;      // 처리한 줄 수 (인덱스와 기록의 줄 번호)
+        uint64_t outputOffset = 0;
+        uint64_t traceOffset = 0;
+        uint64_t verifyLogOffset = 0;   // 검증 기록을 파일에 쓸 때만
+        uint64_t total = 0;
+        uint64_t solved = 0;
+        uint64_t unsolved = 0;
+        uint64_t invalid = 0;
+        uint64_t traceRecords = 0;
+        uint64_t verified = 0;
+        uint64_t mismatches = 0;
+        uint64_t cacheHits = 0;         // 캐시 내용은 남기지 않고 누적 카운터만
+        uint64_t cacheMisses = 0;
+        uint64_t cacheEvictions = 0;
+    };
+
+    // 없거나 형식이 틀리면 false
+    bool load(const char* path, State& state);
+    // 임시 파일에 쓰고 디스크에 내린 뒤 바꿔치기
+    bool save(const char* path, const State& state);
+
+    // 버퍼를 비우고 디스크까지 내림
+    bool sync(FILE* f);
+    // 파일을 size 바이트로 자르고 끝으로 이동 (size보다 짧으면 false)
+    bool truncate(FILE* f, uint64_t size);
+}
@@ -0,0 +1,353 @@
+#include "batch.h"
+#include "enumerator.h"
+#include "generator.h"
+#include "rater.h"
+#include "server.h"
+#include "shard.h"
+#include "trace.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <signal.h>
+#endif
+
+namespace {
+
+#ifdef _WIN32
+HANDLE stopEvent = nullptr;
+
+BOOL WINAPI onConsoleCtrl(DWORD) {
+    SetEvent(stopEvent);
+    return TRUE;
+}
+#endif
+
+void printUsage() {
+    fprintf(stderr,
+        "사용법: sudoku_cli solve <입력> [옵션]\n"
+        "        sudoku_cli convert <입력> [옵션]\n"
+        "        sudoku_cli canon <입력> [옵션]     대칭 표준형(minlex)으로 변환\n"
+        "        sudoku_cli rate <입력> [옵션]      난이도 평가 (퍼즐, 점수, 단계)\n"
+        "        sudoku_cli minimize <입력> [옵션]  불필요한 단서 제거\n"
+        "  <입력>이 -이면 표준 입력에서 읽음 (텍스트만)\n"
+        "  -o <파일>           출력 파일 (기본: stdout)\n"
+        "  -t <개수>           스레드 수 (기본: 코어 수)\n"
+        "  --backtrack         논리 전략으로 안 풀리면 백트래킹\n"
+        "  --variant <종류>    classic, x, windoku, jigsaw (퍼즐 뒤에 영역 81글자),\n"
+        "                      killer (퍼즐 뒤에 케이지 81글자와 케이지 합 목록)\n"
+        "  --format text|bin   출력 형식 (기본: text, 입력 형식은 자동 판별)\n"
+        "  --index             바이너리 출력에 원본 줄 번호 인덱스 추가\n"
+        "  --cache <MB>        해답 캐시 사용 (표준형 키)\n"
+        "  --cache-raw         캐시 키로 원본 퍼즐 사용\n"
+        "  --trace <파일>      풀이 단계 기록 (바이너리)\n"
+        "  --trace-json        풀이 단계 기록을 JSON Lines로\n"
+        "  --report <초>       주기적으로 처리량과 지연 분위수를 stderr에 출력\n"
+        "  --metrics <파일>    Prometheus 텍스트 형식 지표 파일 (보고할 때마다, 끝날 때 갱신)\n"
+        "  --checkpoint <파일> 10초마다 진행 위치 기록, 중단 뒤 같은 명령으로 이어서 처리\n"
+        "  --verify <비율>     해를 모두 규칙으로 확인하고, 비율(0-1)만큼은 기준 엔진으로 다시 풀어 비교 (solve)\n"
+        "  --verify-ref search|simple   기준 엔진 (기본: search, 백트래킹 탐색)\n"
+        "  --verify-log <파일> 불일치 기록 (기본: stderr)\n"
+        "  -p <개수>           입력을 나눠 여러 프로세스로 처리한 뒤 합침 (-t는 프로세스당 스레드 수)\n"
+        "  --pin               -p의 프로세스마다 겹치지 않는 코어에 고정\n"
+        "  --range <시작>:<끝> 입력 일부만 처리 (텍스트: 바이트, 바이너리: 레코드)\n"
+        "  --stats <파일>      요약 통계를 stderr 대신 파일에 (-p의 워커용)\n"
+        "  --line-base <줄 수> 줄 번호를 이만큼 더해 셈 (--range로 나눈 조각을 파일 기준으로 보고, -p의 워커용)\n"
+        "\n"
+        "        sudoku_cli serve [--tcp <포트>] [--unix <경로>] [옵션]\n"
+        "  -t <개수>           워커 스레드 수\n"
+        "  --batch <개수>      워커가 한 번에 처리하는 요청 수 (기본: 64)\n"
+        "  --backtrack, --cache <MB>, --report <초>, --metrics <파일>\n"
+        "\n"
+        "        sudoku_cli enumerate <입력> [옵션]    줄마다 퍼즐의 해를 모두 나열\n"
+        "  -o <파일>, -t <개수>, --format text|bin, --variant classic|x|windoku\n"
+        "  --limit <개수>      퍼즐당 해 수 한도 (기본: 모두)\n"
+        "  --index             바이너리 출력에 해마다 퍼즐의 원본 줄 번호 인덱스 추가\n"
+        "                      (텍스트 출력은 퍼즐마다 해 앞에 \"# 줄 <번호>\" 줄을 씀)\n"
+        "\n"
+        "        sudoku_cli generate -n <개수> [옵션]   유일해 퍼즐 생성 (퍼즐, 점수, 단계)\n"
+        "  -o <파일>, -t <개수>\n"
+        "  --seed <값>         난수 시드 (기본: 무작위)\n"
+        "  --symmetry none|rot|diag|mirror   단서 배치 대칭 (기본: none)\n"
+        "  --min <점수>        최소 난이도 점수\n"
+        "  --max <점수>        최대 난이도 점수\n"
+        "  --no-backtrack      논리 전략만으로 풀리는 퍼즐만 생성\n"
+        "  --max-rejects <개수> 범위 밖 퍼즐을 연달아 이만큼 버리면 포기 (기본: 100000, 0이면 제한 없음)\n");
+}
+
+int runBatch(int argc, char** argv, Batch::Mode mode) {
+    Batch::Options options;
+    options.mode = mode;
+    // -p로 나눠 처리하면 입력, 출력, 스레드 수, 범위를 뺀 나머지 옵션은 워커에 그대로 넘김
+    Shard::Options shard;
+    int processes = 0;
+    shard.args.push_back(argv[1]);
+    const char* statsPath = nullptr;
+    bool ranged = false;
+    for (int i = 2; i < argc; i++) {
+        int first = i;
+        bool forward = false;
+        if (!strcmp(argv[i], "-o") && i + 1 < argc) options.outputPath = argv[++i];
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc) options.threads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-p") && i + 1 < argc) processes = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--pin")) shard.pin = true;
+        else if (!strcmp(argv[i], "--stats") && i + 1 < argc) statsPath = argv[++i];
+        else if (!strcmp(argv[i], "--range") && i + 1 < argc) {
+            unsigned long long begin, end;
+            if (sscanf(argv[++i], "%llu:%llu", &begin, &end) != 2 || begin > end) { printUsage(); return 2; }
+            options.rangeBegin = begin;
+            options.rangeEnd = end;
+            ranged = true;
+        }
+        else if (!strcmp(argv[i], "--line-base") && i + 1 < argc) options.lineBase = strtoull(argv[++i], nullptr, 10);
+        else if ((argv[i][0] != '-' || !argv[i][1]) && !options.inputPath) options.inputPath = argv[i];
+        else forward = true;
+        if (!forward) continue;
+
+        if (!strcmp(argv[i], "--backtrack")) options.useBacktrack = true;
+        else if (!strcmp(argv[i], "--index")) options.writeIndex = true;
+        else if (!strcmp(argv[i], "--cache") && i + 1 < argc) options.cacheBytes = (size_t)atoll(argv[++i]) << 20;
+        else if (!strcmp(argv[i], "--cache-raw")) options.cacheCanonical = false;
+        else if (!strcmp(argv[i], "--trace") && i + 1 < argc) options.tracePath = argv[++i];
+        else if (!strcmp(argv[i], "--trace-json")) options.traceJson = true;
+        else if (!strcmp(argv[i], "--metrics") && i + 1 < argc) options.metricsPath = argv[++i];
+        else if (!strcmp(argv[i], "--report") && i + 1 < argc) options.reportInterval = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--checkpoint") && i + 1 < argc) options.checkpointPath = argv[++i];
+        else if (!strcmp(argv[i], "--verify") && i + 1 < argc) {
+            options.verify = true;
+            options.verifySample = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--verify-log") && i + 1 < argc) options.verifyLogPath = argv[++i];
+        else if (!strcmp(argv[i], "--verify-ref") && i + 1 < argc) {
+            const char* ref = argv[++i];
+            if (!strcmp(ref, "search")) options.verifyReference = Verifier::Reference::Search;
+            else if (!strcmp(ref, "simple")) options.verifyReference = Verifier::Reference::Simple;
+            else { printUsage(); return 2; }
+        }
+        else if (!strcmp(argv[i], "--variant") && i + 1 < argc) {
+            const char* name = argv[++i];
+            if (!strcmp(name, "classic")) options.variant = Variant::Kind::Classic;
+            else if (!strcmp(name, "x")) options.variant = Variant::Kind::Diagonal;
+            else if (!strcmp(name, "windoku")) options.variant = Variant::Kind::Windoku;
+            else if (!strcmp(name, "jigsaw")) options.variant = Variant::Kind::Jigsaw;
+            else if (!strcmp(name, "killer")) options.variant = Variant::Kind::Killer;
+            else { printUsage(); return 2; }
+        }
+        else if (!strcmp(argv[i], "--format") && i + 1 < argc) {
+            const char* fmt = argv[++i];
+            if (!strcmp(fmt, "text")) options.outputFormat = Batch::Format::Text;
+            else if (!strcmp(fmt, "bin")) options.outputFormat = Batch::Format::Binary;
+            else { printUsage(); return 2; }
+        }
+        else { printUsage(); return 2; }
+        for (int j = first; j <= i; j++) shard.args.push_back(argv[j]);
+    }
+    if (!options.inputPath || processes < 0) { printUsage(); return 2; }
+    if (options.tracePath && !Trace::COMPILED) {
+        fprintf(stderr, "이 빌드는 풀이 단계 기록을 지원하지 않습니다 (SUDOKU_ENABLE_TRACE)\n");
+        return 2;
+    }
+    if (mode == Batch::Mode::Canonical && options.variant != Variant::Kind::Classic) {
+        fprintf(stderr, "canon은 기본 퍼즐만 지원합니다\n");
+        return 2;
+    }
+    if (options.verify && mode != Batch::Mode::Solve) {
+        fprintf(stderr, "--verify는 solve에서만 쓸 수 있습니다\n");
+        return 2;
+    }
+    if (mode == Batch::Mode::Rate && options.outputFormat != Batch::Format::Text) {
+        fprintf(stderr, "rate는 텍스트로만 출력합니다\n");
+        return 2;
+    }
+
+    if (processes > 0 && (!strcmp(options.inputPath, "-") || options.tracePath || options.checkpointPath
+        || options.metricsPath || options.reportInterval > 0 || options.verifyLogPath || ranged || statsPath
+        || options.lineBase)) {
+        fprintf(stderr, "-p는 파일 입력에서만 쓸 수 있고 --trace, --checkpoint, --metrics, --report, --verify-log와는 함께 쓸 수 없습니다\n");
+        return 2;
+    }
+
+    Batch::Stats stats;
+    bool ok;
+    if (processes > 0) {
+        shard.processes = processes;
+        shard.program = argv[0];
+        shard.inputPath = options.inputPath;
+        shard.outputPath = options.outputPath;
+        shard.threads = options.threads;
+        shard.outputFormat = options.outputFormat;
+        ok = Shard::run(shard, stats);
+    } else {
+        ok = Batch::solveFile(options, stats);
+    }
+    if (statsPath) {
+        if (!Shard::writeStats(statsPath, stats)) {
+            fprintf(stderr, "통계 파일을 쓸 수 없습니다: %s\n", statsPath);
+            ok = false;
+        }
+        return ok ? 0 : 1;
+    }
+    if (stats.resumed > 0) fprintf(stderr, "체크포인트에서 이어서 처리: 앞의 %llu개 건너뜀\n", (unsigned long long)stats.resumed);
+    fprintf(stderr, "전체 %zu, 해결 %zu, 미해결 %zu, 오류 %zu\n",
+        stats.total, stats.solved, stats.unsolved, stats.invalid);
+    if (options.cacheBytes > 0) {
+        fprintf(stderr, "캐시 적중 %llu, 실패 %llu, 제거 %llu\n", (unsigned long long)stats.cacheHits,
+            (unsigned long long)stats.cacheMisses, (unsigned long long)stats.cacheEvictions);
+    }
+    if (options.tracePath) {
+        fprintf(stderr, "기록 %llu, 유실 %llu\n", (unsigned long long)stats.traceRecords,
+            (unsigned long long)stats.traceDropped);
+    }
+    if (options.verify) {
+        fprintf(stderr, "검증 %llu, 불일치 %llu\n", (unsigned long long)stats.verified, (unsigned long long)stats.mismatches);
+    }
+    if (options.metricsPath || options.reportInterval > 0) {
+        fprintf(stderr, "백트래킹 %llu, 지연 p50 %.3fms p99 %.3fms p999 %.3fms 최대 %.3fms\n",
+            (unsigned long long)stats.backtracks, stats.latencyP50 / 1e6, stats.latencyP99 / 1e6,
+            stats.latencyP999 / 1e6, stats.latencyMax / 1e6);
+    }
+    return ok ? 0 : 1;
+}
+
+int runServe(int argc, char** argv) {
+    SolverServer::Options options;
+    for (int i = 2; i < argc; i++) {
+        if (!strcmp(argv[i], "--tcp") && i + 1 < argc) options.tcpPort = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--unix") && i + 1 < argc) options.unixPath = argv[++i];
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc) options.threads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--batch") && i + 1 < argc) options.maxBatch = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--backtrack")) options.useBacktrack = true;
+        else if (!strcmp(argv[i], "--cache") && i + 1 < argc) options.cacheBytes = (size_t)atoll(argv[++i]) << 20;
+        else if (!strcmp(argv[i], "--report") && i + 1 < argc) options.reportInterval = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--metrics") && i + 1 < argc) options.metricsPath = argv[++i];
+        else { printUsage(); return 2; }
+    }
+    if ((options.tcpPort <= 0 && !options.unixPath) || options.maxBatch <= 0) { printUsage(); return 2; }
+
+    // 종료 시그널은 이 스레드에서만 받도록 서버 스레드를 만들기 전에 막아 둠
+#ifdef _WIN32
+    stopEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+    SetConsoleCtrlHandler(onConsoleCtrl, TRUE);
+#else
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+#endif
+
+    SolverServer server(options);
+    if (!server.start()) return 1;
+    if (options.tcpPort > 0) fprintf(stderr, "127.0.0.1:%d 대기 중\n", options.tcpPort);
+    if (options.unixPath) fprintf(stderr, "%s 대기 중\n", options.unixPath);
+
+    // Ctrl+C나 SIGTERM을 받으면 멈춰서 마지막 지표를 쓰고 소켓 파일을 지움
+#ifdef _WIN32
+    WaitForSingleObject(stopEvent, INFINITE);
+#else
+    int sig = 0;
+    sigwait(&signals, &sig);
+#endif
+    fprintf(stderr, "종료 중...\n");
+    server.stop();
+    fprintf(stderr, "처리 %llu\n", (unsigned long long)server.getServed());
+    return 0;
+}
+
+int runGenerate(int argc, char** argv) {
+    Generator::Options options;
+    const char* outputPath = nullptr;
+    options.count = 0;
+    for (int i = 2; i < argc; i++) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc) options.count = (size_t)atoll(argv[++i]);
+        else if (!strcmp(argv[i], "-o") && i + 1 < argc) outputPath = argv[++i];
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc) options.threads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) options.seed = strtoull(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--min") && i + 1 < argc) options.minScore = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--max") && i + 1 < argc) options.maxScore = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--no-backtrack")) options.allowBacktrack = false;
+        else if (!strcmp(argv[i], "--max-rejects") && i + 1 < argc) options.maxRejects = (size_t)atoll(argv[++i]);
+        else if (!strcmp(argv[i], "--symmetry") && i + 1 < argc) {
+            const char* sym = argv[++i];
+            if (!strcmp(sym, "none")) options.symmetry = Generator::Symmetry::None;
+            else if (!strcmp(sym, "rot")) options.symmetry = Generator::Symmetry::Rotational;
+            else if (!strcmp(sym, "diag")) options.symmetry = Generator::Symmetry::Diagonal;
+            else if (!strcmp(sym, "mirror")) options.symmetry = Generator::Symmetry::Mirror;
+            else { printUsage(); return 2; }
+        }
+        else { printUsage(); return 2; }
+    }
+    if (options.count == 0 || options.minScore > options.maxScore) { printUsage(); return 2; }
+    if (!Rater::reachable(options.minScore, options.maxScore, options.allowBacktrack)) {
+        fprintf(stderr, "난이도 범위 %.1f-%.1f에 들 수 있는 점수가 없습니다 (논리 전략 1.5-7.0%s)\n",
+            options.minScore, options.maxScore, options.allowBacktrack ? ", 백트래킹 10.0" : "");
+        return 2;
+    }
+
+    FILE* out = outputPath ? fopen(outputPath, "wb") : stdout;
+    if (!out) {
+        fprintf(stderr, "출력 파일을 열 수 없습니다: %s\n", outputPath);
+        return 1;
+    }
+    Generator::Stats stats;
+    bool ok = Generator::generate(options, out, stats);
+    if (outputPath) fclose(out);
+    else fflush(out);
+    fprintf(stderr, "생성 %zu, 난이도 범위 밖 %zu\n", stats.generated, stats.rejected);
+    return ok ? 0 : 1;
+}
+
+int runEnumerate(int argc, char** argv) {
+    Enumerator::Options options;
+    for (int i = 2; i < argc; i++) {
+        if (!strcmp(argv[i], "-o") && i + 1 < argc) options.outputPath = argv[++i];
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc) options.threads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--limit") && i + 1 < argc) options.limit = strtoull(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--index")) options.writeIndex = true;
+        else if (!strcmp(argv[i], "--variant") && i + 1 < argc) {
+            const char* name = argv[++i];
+            if (!strcmp(name, "classic")) options.variant = Variant::Kind::Classic;
+            else if (!strcmp(name, "x")) options.variant = Variant::Kind::Diagonal;
+            else if (!strcmp(name, "windoku")) options.variant = Variant::Kind::Windoku;
+            else { printUsage(); return 2; }
+        }
+        else if (!strcmp(argv[i], "--format") && i + 1 < argc) {
+            const char* fmt = argv[++i];
+            if (!strcmp(fmt, "text")) options.outputFormat = Batch::Format::Text;
+            else if (!strcmp(fmt, "bin")) options.outputFormat = Batch::Format::Binary;
+            else { printUsage(); return 2; }
+        }
+        else if (argv[i][0] != '-' && !options.inputPath) options.inputPath = argv[i];
+        else { printUsage(); return 2; }
+    }
+    if (!options.inputPath) { printUsage(); return 2; }
+
+    Enumerator::Stats stats;
+    bool ok = Enumerator::run(options, stats);
+    fprintf(stderr, "퍼즐 %zu, 해 %llu, 한도 도달 %zu, 오류 %zu\n", stats.puzzles,
+        (unsigned long long)stats.solutions, stats.limited, stats.invalid);
+    return ok ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    if (argc < 2) { printUsage(); return 2; }
+    if (!strcmp(argv[1], "solve")) return runBatch(argc, argv, Batch::Mode::Solve);
+    if (!strcmp(argv[1], "convert")) return runBatch(argc, argv, Batch::Mode::Convert);
+    if (!strcmp(argv[1], "canon")) return runBatch(argc, argv, Batch::Mode::Canonical);
+    if (!strcmp(argv[1], "rate")) return runBatch(argc, argv, Batch::Mode::Rate);
+    if (!strcmp(argv[1], "minimize")) return runBatch(argc, argv, Batch::Mode::Minimize);
+    if (!strcmp(argv[1], "serve")) return runServe(argc, argv);
+    if (!strcmp(argv[1], "generate")) return runGenerate(argc, argv);
+    if (!strcmp(argv[1], "enumerate")) return runEnumerate(argc, argv);
+    printUsage();
+    return 2;
+}
@@ -0,0 +1,108 @@
+#include "corpus_reader.h"
+#include <cstring>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+CorpusReader::CorpusReader() : base(nullptr), length(0), hFile(INVALID_HANDLE_VALUE), hMapping(nullptr) {}
+#else
+CorpusReader::CorpusReader() : base(nullptr), length(0), fd(-1) {}
+#endif
+
+CorpusReader::~CorpusReader() { close(); }
+
+bool CorpusReader::open(const char* path) {
+    close();
+#ifdef _WIN32
+    hFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) return false;
+    if (GetFileType(hFile) != FILE_TYPE_DISK) { close(); return false; }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(hFile, &fileSize)) { close(); return false; }
+    length = (size_t)fileSize.QuadPart;
+    if (length == 0) return true;
+    hMapping = CreateFileMapping(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!hMapping) { close(); return false; }
+    base = (const char*)MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+    if (!base) { close(); return false; }
+#else
+    fd = ::open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) { close(); return false; }
+    length = (size_t)st.st_size;
+    if (length == 0) return true;
+    void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) { close(); return false; }
+    base = (const char*)p;
+    madvise(p, length, MADV_SEQUENTIAL);
+#endif
+    return true;
+}
+
+void CorpusReader::close() {
+#ifdef _WIN32
+    if (base) UnmapViewOfFile(base);
+    if (hMapping) CloseHandle(hMapping);
+    if (hFile != INVALID_HANDLE_VALUE) CloseHandle(hFile);
+    hMapping = nullptr;
+    hFile = INVALID_HANDLE_VALUE;
+#else
+    if (base) munmap((void*)base, length);
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+#endif
+    base = nullptr;
+    length = 0;
+}
+
+void CorpusReader::release(const char* begin, const char* end) const {
+#ifdef _WIN32
+    // 읽기 전용 파일 매핑 페이지는 캐시 관리자가 회수
+    (void)begin; (void)end;
+#else
+    // 페이지 경계 안쪽만 해제
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t from = ((size_t)(begin - base) + page - 1) / page * page;
+    size_t to = (size_t)(end - base) / page * page;
+    if (to > from) madvise((void*)(base + from), to - from, MADV_DONTNEED);
+#endif
+}
+
+const char* CorpusReader::nextLine(const char* p, const char* end, const char*& lineEnd) {
+    const char* nl = (const char*)memchr(p, '\n', end - p);
+    const char* next = nl ? nl + 1 : end;
+    lineEnd = nl ? nl : end;
+    if (lineEnd > p && lineEnd[-1] == '\r') lineEnd--;
+    return next;
+}
+
+const char* CorpusReader::lineStart(const char* begin, const char* end, const char* p) {
+    if (p <= begin || p >= end || p[-1] == '\n') return p;
+    const char* nl = (const char*)memchr(p, '\n', end - p);
+    return nl ? nl + 1 : end;
+}
+
+bool CorpusReader::parse(const char* line, const char* lineEnd, SudokuGrid& grid) {
+    if (lineEnd - line < 81) return false;
+    grid.reset();
+    for (int idx = 0; idx < 81; idx++) {
+        char ch = line[idx];
+        if (ch == '.' || ch == '0') continue;
+        if (ch < '1' || ch > '9') return false;
+        int row = idx / 9, col = idx % 9, num = ch - '0';
+        if (!grid.isValidMove(row, col, num)) return false;
+        grid.setCell(row, col, num);
+        grid.isOriginal[row][col] = true;
+    }
+    return true;
+}
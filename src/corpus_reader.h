@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include "sudoku_grid.h"
+
+// 퍼즐 파일을 메모리 매핑으로 읽는 리더 (한 줄에 81글자, '.'/'0' = 빈칸)
+class CorpusReader {
+public:
+    CorpusReader();
+    ~CorpusReader();
+    CorpusReader(const CorpusReader&) = delete;
+    CorpusReader& operator=(const CorpusReader&) = delete;
+
+    // 일반 파일만 매핑 (파이프나 장치는 false이므로 스트림으로 읽어야 함)
+    bool open(const char* path);
+    void close();
+
+    const char* data() const { return base; }
+    size_t size() const { return length; }
+
+    // 처리가 끝난 영역의 페이지를 해제 (RAM보다 큰 입력용)
+    void release(const char* begin, const char* end) const;
+
+    // [p, end)에서 다음 줄을 찾아 lineEnd에 줄 끝을 기록, 다음 줄 시작을 반환
+    static const char* nextLine(const char* p, const char* end, const char*& lineEnd);
+
+    // [begin, end)에서 p가 줄 중간이면 다음 줄 시작으로 (이미 줄 시작이면 그대로, 없으면 end)
+    static const char* lineStart(const char* begin, const char* end, const char* p);
+
+    // 한 줄을 그리드에 직접 파싱 (81칸 미만이거나 규칙 위반이면 false)
+    static bool parse(const char* line, const char* lineEnd, SudokuGrid& grid);
+
+private:
+    const char* base;
+    size_t length;
+#ifdef _WIN32
+    void* hFile;
+    void* hMapping;
+#else
+    int fd;
+#endif
+};
@@ -0,0 +1,207 @@
+#include "enumerator.h"
+#include "binary_format.h"
+#include "corpus_reader.h"
+#include "strategies.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace Enumerator {
+
+namespace {
+
+// 스레드마다 이만큼 모이면 출력에 씀. 가지는 스레드당 이 수만큼 나눠 일이 고르게 돌아가게 함
+const size_t FLUSH_BYTES = 256u << 10;
+const size_t SUBTREES_PER_THREAD = 16;
+
+struct Sink {
+    FILE* out;
+    bool binary;
+    std::mutex mtx;
+    bool failed = false;
+
+    void append(const SudokuGrid& grid, std::string& buf) const {
+        if (binary) {
+            unsigned char record[BinaryFormat::CELL_BYTES + BinaryFormat::GIVENS_BYTES];
+            BinaryFormat::encode(grid, BinaryFormat::HAS_GIVENS, record);
+            buf.append((const char*)record, sizeof(record));
+        } else {
+            char text[82];
+            Batch::formatGrid(grid, text);
+            text[81] = '\n';
+            buf.append(text, 82);
+        }
+    }
+
+    void flush(std::string& buf) {
+        if (buf.empty()) return;
+        std::lock_guard<std::mutex> lock(mtx);
+        if (fwrite(buf.data(), 1, buf.size(), out) != buf.size()) failed = true;
+        buf.clear();
+    }
+};
+
+// 한 퍼즐의 해를 나열해 찾은 수를 반환 (한도에서 멈췄으면 limited)
+uint64_t enumerate(const SudokuGrid& puzzle, uint64_t limit, int threads, Sink& sink, bool& limited) {
+    std::vector<SudokuGrid> subtrees;
+    Strategies::splitSearch(puzzle, threads > 1 ? (size_t)threads * SUBTREES_PER_THREAD : 1, subtrees);
+
+    std::atomic<size_t> nextTree(0);
+    std::atomic<uint64_t> claimed(0);   // 한도가 있을 때만 씀
+    std::atomic<uint64_t> found(0);
+    std::atomic<bool> stop(false);
+
+    auto worker = [&]() {
+        std::string buf;
+        uint64_t local = 0;
+        auto visit = [&](const SudokuGrid& grid) {
+            if (stop.load(std::memory_order_relaxed)) return false;
+            if (limit && claimed.fetch_add(1, std::memory_order_relaxed) >= limit) {
+                stop = true;
+                return false;
+            }
+            sink.append(grid, buf);
+            local++;
+            if (buf.size() >= FLUSH_BYTES) sink.flush(buf);
+            return true;
+        };
+        size_t i;
+        while (!stop.load(std::memory_order_relaxed) && (i = nextTree++) < subtrees.size()) {
+            Strategies::enumerateSolutions(subtrees[i], visit);
+        }
+        sink.flush(buf);
+        found += local;
+    };
+
+    int n = (int)std::min<size_t>((size_t)threads, subtrees.size());
+    if (n <= 1) {
+        worker();
+    } else {
+        std::vector<std::thread> pool;
+        for (int t = 0; t < n; t++) pool.emplace_back(worker);
+        for (auto& t : pool) t.join();
+    }
+    limited = stop.load();
+    return found.load();
+}
+
+} // namespace
+
+bool run(const Options& options, Stats& stats) {
+    stats = Stats();
+    CorpusReader reader;
+    if (!options.inputPath || !reader.open(options.inputPath)) {
+        fprintf(stderr, "입력 파일을 열 수 없습니다: %s\n", options.inputPath ? options.inputPath : "");
+        return false;
+    }
+    if (BinaryFormat::isBinary(reader.data(), reader.size())) {
+        fprintf(stderr, "해 나열은 텍스트 입력만 지원합니다: %s\n", options.inputPath);
+        return false;
+    }
+    if (options.variant != Variant::Kind::Classic && options.variant != Variant::Kind::Diagonal
+        && options.variant != Variant::Kind::Windoku) {
+        fprintf(stderr, "해 나열은 기본, X, 윈도쿠 퍼즐만 지원합니다\n");
+        return false;
+    }
+    const Variant& variant = options.variant == Variant::Kind::Diagonal ? Variant::diagonal()
+        : options.variant == Variant::Kind::Windoku ? Variant::windoku() : Variant::classic();
+    int threads = options.threads > 0 ? options.threads : (int)std::thread::hardware_concurrency();
+    if (threads <= 0) threads = 1;
+
+    FILE* out = options.outputPath ? fopen(options.outputPath, "wb") : stdout;
+    if (!out) {
+        fprintf(stderr, "출력 파일을 열 수 없습니다: %s\n", options.outputPath);
+        return false;
+    }
+    bool binary = options.outputFormat == Batch::Format::Binary;
+#ifdef _WIN32
+    if (out == stdout && binary) _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    Sink sink;
+    sink.out = out;
+    sink.binary = binary;
+
+    // 인덱스는 헤더에 위치를 적어야 하므로 되감을 수 있을 때만
+    bool seekable = out != stdout || fseek(out, 0, SEEK_CUR) == 0;
+    bool writeIndex = binary && options.writeIndex && seekable;
+    // 퍼즐의 해는 연달아 나오므로 (줄 번호, 해 수)만 모아 두고 끝에 펼쳐 씀
+    std::vector<std::pair<uint64_t, uint64_t>> runs;
+
+    BinaryFormat::Header header;
+    header.flags = BinaryFormat::HAS_GIVENS;
+    header.recordSize = (uint32_t)BinaryFormat::recordSize(header.flags);
+    header.recordCount = BinaryFormat::UNKNOWN_COUNT;
+    if (binary) {
+        unsigned char buf[BinaryFormat::HEADER_SIZE];
+        BinaryFormat::writeHeader(header, buf);
+        if (fwrite(buf, 1, sizeof(buf), out) != sizeof(buf)) sink.failed = true;
+    }
+
+    SudokuGrid grid;
+    grid.setVariant(variant);
+    const char* p = reader.data();
+    const char* end = p + reader.size();
+    uint64_t lineNo = 0;
+    while (p < end && !sink.failed) {
+        const char* lineEnd;
+        const char* next = CorpusReader::nextLine(p, end, lineEnd);
+        lineNo++;
+        if (lineEnd == p || *p == '#') { p = next; continue; }
+        stats.puzzles++;
+        if (!CorpusReader::parse(p, lineEnd, grid)) {
+            fprintf(stderr, "줄 %llu: 잘못된 퍼즐\n", (unsigned long long)lineNo);
+            stats.invalid++;
+            p = next;
+            continue;
+        }
+        if (!binary && fprintf(out, "# 줄 %llu\n", (unsigned long long)lineNo) < 0) sink.failed = true;
+        bool limited = false;
+        uint64_t found = enumerate(grid, options.limit, threads, sink, limited);
+        if (writeIndex && found) runs.emplace_back(lineNo - 1, found);
+        stats.solutions += found;
+        if (limited) stats.limited++;
+        fprintf(stderr, "줄 %llu: 해 %llu개%s\n", (unsigned long long)lineNo, (unsigned long long)found,
+            limited ? " (한도에서 멈춤)" : "");
+        p = next;
+    }
+
+    bool ok = !sink.failed;
+    if (ok && writeIndex) {
+        // 줄 번호는 0부터 (solve의 --index와 같음)
+        std::string buf;
+        unsigned char line[8];
+        for (const auto& run : runs) {
+            BinaryFormat::writeU64(run.first, line);
+            for (uint64_t k = 0; k < run.second; k++) {
+                buf.append((const char*)line, 8);
+                if (buf.size() >= FLUSH_BYTES) sink.flush(buf);
+            }
+        }
+        sink.flush(buf);
+        ok = !sink.failed;
+        header.flags |= BinaryFormat::HAS_INDEX;
+        header.indexOffset = BinaryFormat::HEADER_SIZE + stats.solutions * header.recordSize;
+    }
+    // 되감을 수 있으면 헤더에 레코드 수를 기록
+    if (binary && fseek(out, 0, SEEK_SET) == 0) {
+        header.recordCount = stats.solutions;
+        unsigned char buf[BinaryFormat::HEADER_SIZE];
+        BinaryFormat::writeHeader(header, buf);
+        if (fwrite(buf, 1, sizeof(buf), out) != sizeof(buf)) ok = false;
+    }
+    if (out != stdout) { if (fclose(out) != 0) ok = false; }
+    else fflush(out);
+    if (!ok) fprintf(stderr, "출력을 쓸 수 없습니다: %s\n", options.outputPath ? options.outputPath : "stdout");
+    return ok;
+}
+
+} // namespace Enumerator
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "batch.h"
+#include "variant.h"
+
+// 단서가 모자란 그리드(부분 그리드, 템플릿)의 해를 모두 나열해 파일로 흘려 보냄.
+// 탐색 나무의 위쪽 가지들을 여러 스레드가 나눠 맡고, 스레드마다 모은 해를 덩어리로 씀
+namespace Enumerator {
+    struct Options {
+        const char* inputPath = nullptr;    // 텍스트, 줄마다 퍼즐 하나 (차례로 나열)
+        const char* outputPath = nullptr;   // nullptr이면 stdout
+        int threads = 0;                    // 0이면 코어 수
+        uint64_t limit = 0;                 // 퍼즐당 해 수 한도, 0이면 모두
+        Variant::Kind variant = Variant::Kind::Classic;     // Classic, Diagonal, Windoku
+        Batch::Format outputFormat = Batch::Format::Text;   // 바이너리는 주어진 칸 비트마스크 포함
+        bool writeIndex = false;            // 바이너리 출력에 해마다 퍼즐의 원본 줄 번호 인덱스 추가
+    };
+
+    struct Stats {
+        size_t puzzles = 0;
+        size_t invalid = 0;
+        size_t limited = 0;             // 한도에서 멈춘 퍼즐
+        uint64_t solutions = 0;
+    };
+
+    // 텍스트 출력은 퍼즐마다 해 앞에 "# 줄 <번호>" 줄을 씀 (입력으로 다시 읽으면 주석으로 건너뜀).
+    // 퍼즐마다 해 수를 stderr에 알림. 스레드가 둘 이상이면 퍼즐 안에서 해의 순서는 실행마다 다를 수 있음
+    bool run(const Options& options, Stats& stats);
+}
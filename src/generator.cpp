@@ -0,0 +1,148 @@
+#include "generator.h"
+#include "batch.h"
+#include "minimizer.h"
+#include "rater.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Generator {
+
+namespace {
+
+// 무작위 순서로 후보를 시도하는 백트래킹 (MRV)
+bool fill(std::mt19937_64& rng, SudokuGrid& grid) {
+    int minCand = 10, bestRow = -1, bestCol = -1;
+    for (int i = 0; i < 9 && minCand > 1; i++) {
+        for (int j = 0; j < 9; j++) {
+            if (grid.getValue(i, j) == 0) {
+                int count = SudokuGrid::countBits(grid.getCandidates(i, j));
+                if (count < minCand) {
+                    minCand = count;
+                    bestRow = i;
+                    bestCol = j;
+                    if (count <= 1) break;
+                }
+            }
+        }
+    }
+    if (bestRow == -1) return true;
+
+    int nums[9], n = 0;
+    int cand = grid.getCandidates(bestRow, bestCol);
+    for (int num = 1; num <= 9; num++) {
+        if (cand & (1 << (num - 1))) nums[n++] = num;
+    }
+    std::shuffle(nums, nums + n, rng);
+    for (int k = 0; k < n; k++) {
+        SudokuGrid next = grid;
+        next.setCell(bestRow, bestCol, nums[k]);
+        if (fill(rng, next)) {
+            grid = next;
+            return true;
+        }
+    }
+    return false;
+}
+
+// 대칭으로 묶이는 칸 (자기 자신 포함, 최대 2칸)
+int orbit(Symmetry symmetry, int cell, int* out) {
+    int r = cell / 9, c = cell % 9;
+    int other = cell;
+    switch (symmetry) {
+        case Symmetry::Rotational: other = 80 - cell; break;
+        case Symmetry::Diagonal:   other = c * 9 + r; break;
+        case Symmetry::Mirror:     other = r * 9 + (8 - c); break;
+        case Symmetry::None:       break;
+    }
+    out[0] = cell;
+    if (other == cell) return 1;
+    out[1] = other;
+    return 2;
+}
+
+} // namespace
+
+void randomSolution(std::mt19937_64& rng, SudokuGrid& grid) {
+    // 빈 그리드에서는 항상 해가 있음
+    grid.reset();
+    fill(rng, grid);
+}
+
+void carve(std::mt19937_64& rng, Symmetry symmetry, SudokuGrid& grid) {
+    int solution[81];
+    for (int i = 0; i < 81; i++) solution[i] = grid.getValue(i / 9, i % 9);
+
+    int order[81];
+    for (int i = 0; i < 81; i++) order[i] = i;
+    std::shuffle(order, order + 81, rng);
+
+    // 단서가 필요한지는 제거할수록 강해지므로 각 궤도를 한 번씩만 시도하면 됨
+    for (int k = 0; k < 81; k++) {
+        int cells[2];
+        int n = orbit(symmetry, order[k], cells);
+        if (grid.getValue(cells[0] / 9, cells[0] % 9)) Minimizer::tryRemove(grid, solution, cells, n);
+    }
+
+    for (int i = 0; i < 81; i++) grid.isOriginal[i / 9][i % 9] = grid.getValue(i / 9, i % 9) != 0;
+}
+
+bool generate(const Options& options, FILE* out, Stats& stats) {
+    stats = Stats();
+    int threads = options.threads > 0 ? options.threads : (int)std::thread::hardware_concurrency();
+    if (threads <= 0) threads = 1;
+    uint64_t seed = options.seed ? options.seed : std::random_device()() ^ ((uint64_t)std::random_device()() << 32);
+
+    std::atomic<size_t> produced(0);
+    std::atomic<size_t> rejected(0);
+    std::atomic<size_t> sinceAccepted(0);   // 마지막으로 받아들인 뒤 연달아 버린 수 (모든 스레드)
+    std::atomic<bool> gaveUp(false);
+    std::atomic<bool> failed(false);
+    std::mutex outMtx;
+
+    auto worker = [&](int index) {
+        // 스레드마다 독립된 난수 생성기
+        std::seed_seq seq{ (uint32_t)seed, (uint32_t)(seed >> 32), (uint32_t)index };
+        std::mt19937_64 rng(seq);
+        SudokuGrid grid;
+        Rater::Rating rating;
+        char line[96];
+
+        while (produced.load() < options.count && !failed) {
+            randomSolution(rng, grid);
+            carve(rng, options.symmetry, grid);
+            Rater::rate(grid, rating, options.allowBacktrack);
+            if (!rating.solved || rating.score < options.minScore || rating.score > options.maxScore) {
+                rejected++;
+                if (options.maxRejects && ++sinceAccepted > options.maxRejects) {
+                    gaveUp = true;
+                    failed = true;
+                }
+                continue;
+            }
+            sinceAccepted = 0;
+            if (produced.fetch_add(1) >= options.count) break;
+
+            Batch::formatGrid(grid, line);
+            int n = snprintf(line + 81, sizeof(line) - 81, " %.1f %d\n", rating.score, rating.maxTier);
+            std::lock_guard<std::mutex> lock(outMtx);
+            if (fwrite(line, 1, 81 + n, out) != (size_t)(81 + n)) failed = true;
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) pool.emplace_back(worker, t);
+    for (auto& t : pool) t.join();
+
+    stats.generated = std::min(produced.load(), options.count);
+    stats.rejected = rejected.load();
+    if (gaveUp) {
+        fprintf(stderr, "난이도 범위 %.1f-%.1f의 퍼즐을 %zu번 연달아 얻지 못해 멈춥니다\n",
+            options.minScore, options.maxScore, options.maxRejects);
+    }
+    return !failed;
+}
+
+} // namespace Generator
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include "sudoku_grid.h"
+
+// 유일해 퍼즐 생성기: 무작위 완성 그리드 → 대칭 패턴으로 단서 제거 → 난이도로 선별
+namespace Generator {
+    enum class Symmetry {
+        None,
+        Rotational,     // 180도 회전
+        Diagonal,       // 주대각선 대칭
+        Mirror,         // 좌우 대칭
+    };
+
+    struct Options {
+        size_t count = 1;
+        int threads = 0;                // 0이면 코어 수
+        uint64_t seed = 0;              // 0이면 무작위
+        Symmetry symmetry = Symmetry::None;
+        double minScore = 0.0;          // Rater 점수 범위
+        double maxScore = 100.0;
+        bool allowBacktrack = true;     // 백트래킹이 필요한 퍼즐도 허용 (점수 10.0)
+        size_t maxRejects = 100000;     // 퍼즐 하나를 얻기까지 연달아 버린 수가 이를 넘으면 포기 (0이면 제한 없음)
+    };
+
+    struct Stats {
+        size_t generated = 0;
+        size_t rejected = 0;            // 난이도 범위를 벗어난 퍼즐
+    };
+
+    void randomSolution(std::mt19937_64& rng, SudokuGrid& grid);
+    // 해가 하나뿐인 퍼즐이 될 때까지 대칭 궤도 단위로 단서를 제거
+    void carve(std::mt19937_64& rng, Symmetry symmetry, SudokuGrid& grid);
+
+    // 퍼즐을 한 줄에 하나씩 out에 기록 (쓰기에 실패하거나 난이도 범위를 채우지 못하고 포기하면 false)
+    bool generate(const Options& options, FILE* out, Stats& stats);
+}
@@ -0,0 +1,86 @@
+#include "minimizer.h"
+#include "strategies.h"
+
+namespace Minimizer {
+
+namespace {
+
+// 숫자가 이 칸이 속한 어느 유닛에서든 다른 곳에 들어갈 수 없으면 이 칸의 값은 강제됨
+bool hiddenSingle(const SudokuGrid& grid, int row, int col, int bit) {
+    const Variant& v = grid.getVariant();
+    int cell = row * 9 + col;
+    for (int u = 0; u < v.cellUnitCount(cell); u++) {
+        const uint8_t* cells = v.unit(v.cellUnits(cell)[u]);
+        bool elsewhere = false;
+        for (int k = 0; k < 9 && !elsewhere; k++) {
+            if (cells[k] != cell && (grid.getCandidates(cells[k] / 9, cells[k] % 9) & bit)) elsewhere = true;
+        }
+        if (!elsewhere) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+bool tryRemove(SudokuGrid& clues, const int* solution, const int* cells, int count) {
+    SudokuGrid test = clues;
+    for (int m = 0; m < count; m++) {
+        int row = cells[m] / 9, col = cells[m] % 9;
+        test.clearCell(row, col, test.getValue(row, col));
+    }
+
+    // 지우기 전 퍼즐이 유일해였으므로, 다른 해가 있다면 지운 칸 중 하나는 해답과 다른 값이어야 함.
+    // 전체 해를 세지 않고 그런 해가 있는지만 찾음
+    for (int m = 0; m < count; m++) {
+        int row = cells[m] / 9, col = cells[m] % 9;
+        int bit = 1 << (solution[cells[m]] - 1);
+        int cand = test.getCandidates(row, col);
+        if ((cand & ~bit) == 0 || hiddenSingle(test, row, col, bit)) continue;
+
+        test.setCandidates(row, col, cand & ~bit);
+        bool other = Strategies::countSolutions(test, 1) > 0;
+        test.setCandidates(row, col, cand);
+        if (other) return false;
+    }
+
+    clues = test;
+    return true;
+}
+
+bool minimize(SudokuGrid& puzzle) {
+    SudokuGrid clues(puzzle.getVariant());
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            int val = puzzle.getValue(i, j);
+            if (val) {
+                if (!clues.isValidMove(i, j, val)) return false;
+                clues.setCell(i, j, val);
+            }
+        }
+    }
+    if (Strategies::countSolutions(clues, 2) != 1) return false;
+
+    SudokuGrid solved = clues;
+    Strategies::backtrack(solved);
+    int solution[81];
+    for (int i = 0; i < 81; i++) solution[i] = solved.getValue(i / 9, i % 9);
+
+    // 지울수록 남은 단서는 더 필요해지므로 한 번 필요했던 단서는 다시 볼 필요가 없음
+    for (int cell = 0; cell < 81; cell++) {
+        if (clues.getValue(cell / 9, cell % 9)) tryRemove(clues, solution, &cell, 1);
+    }
+
+    puzzle.reset();
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            int val = clues.getValue(i, j);
+            if (val) {
+                puzzle.setCell(i, j, val);
+                puzzle.isOriginal[i][j] = true;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace Minimizer
@@ -0,0 +1,12 @@
+#pragma once
+#include "sudoku_grid.h"
+
+// 단서 최소화: 남은 단서가 모두 유일해에 필요할 때까지 불필요한 단서를 지움
+namespace Minimizer {
+    // clues: 현재 단서만 놓인 그리드 (후보는 단서에서만 계산된 상태), solution: 그 유일해 (81칸)
+    // cells의 단서를 지워도 해가 하나뿐이면 지우고 true, 아니면 clues를 그대로 두고 false
+    bool tryRemove(SudokuGrid& clues, const int* solution, const int* cells, int count);
+
+    // 행 우선 순서로 한 번씩 시도. 해가 없거나 여럿이면 false (puzzle은 그대로)
+    bool minimize(SudokuGrid& puzzle);
+}
@@ -0,0 +1,98 @@
+#include "rater.h"
+#include "trace.h"
+
+namespace Rater {
+
+using Strategies::StrategyId;
+
+namespace {
+
+struct Rung {
+    StrategyId id;
+    bool (*apply)(SudokuGrid&);
+    double score;
+    int tier;
+    const char* name;
+};
+
+// 점수 오름차순 (가장 싼 전략이 먼저)
+const Rung LADDER[] = {
+    { StrategyId::HiddenSingle,     Strategies::hiddenSingles,    1.5, 0, "Hidden Singles" },
+    { StrategyId::KillerCage,       Strategies::killerCages,      2.0, 0, "Killer Cages" },
+    { StrategyId::NakedSingle,      Strategies::nakedSingles,     2.3, 0, "Naked Singles" },
+    { StrategyId::PointingPair,     Strategies::pointingPairs,    2.6, 1, "Pointing Pairs" },
+    { StrategyId::BoxLineReduction, Strategies::boxLineReduction, 2.8, 1, "Box-Line Reduction" },
+    { StrategyId::NakedPair,        Strategies::nakedPairs,       3.0, 1, "Naked Pairs" },
+    { StrategyId::XWing,            Strategies::xWing,            3.2, 2, "X-Wing" },
+    { StrategyId::HiddenPair,       Strategies::hiddenPairs,      3.4, 1, "Hidden Pairs" },
+    { StrategyId::NakedTriple,      Strategies::nakedTriples,     3.6, 1, "Naked Triples" },
+    { StrategyId::Swordfish,        Strategies::swordfish,        3.8, 2, "Swordfish" },
+    { StrategyId::HiddenTriple,     Strategies::hiddenTriples,    4.0, 1, "Hidden Triples" },
+    { StrategyId::YWing,            Strategies::yWing,            4.2, 2, "Y-Wing" },
+    { StrategyId::ForcingChain,     Strategies::forcingChains,    7.0, 2, "Forcing Chains" },
+};
+
+const double BACKTRACK_SCORE = 10.0;
+
+const Rung* find(StrategyId id) {
+    for (const Rung& r : LADDER) if (r.id == id) return &r;
+    return nullptr;
+}
+
+} // namespace
+
+bool reachable(double minScore, double maxScore, bool allowBacktrack) {
+    if (allowBacktrack && BACKTRACK_SCORE >= minScore && BACKTRACK_SCORE <= maxScore) return true;
+    for (const Rung& r : LADDER) {
+        // 킬러 케이지는 킬러 퍼즐에서만 쓰임
+        if (r.id != StrategyId::KillerCage && r.score >= minScore && r.score <= maxScore) return true;
+    }
+    return false;
+}
+
+double score(StrategyId id) {
+    const Rung* r = find(id);
+    return r ? r->score : BACKTRACK_SCORE;
+}
+
+int tier(StrategyId id) {
+    const Rung* r = find(id);
+    return r ? r->tier : 3;
+}
+
+const char* name(StrategyId id) {
+    const Rung* r = find(id);
+    return r ? r->name : "Backtracking";
+}
+
+bool rate(const SudokuGrid& puzzle, Rating& rating, bool allowBacktrack) {
+    rating = Rating();
+    SudokuGrid grid = puzzle;
+    grid.updateCandidates();
+
+    bool previous = Strategies::getStepMode();
+    Strategies::setStepMode(true);
+    while (!grid.isComplete() && grid.isValid()) {
+        SUDOKU_TRACE_STEP();
+        const Rung* applied = nullptr;
+        for (const Rung& r : LADDER) {
+            if (r.apply(grid)) { applied = &r; break; }
+        }
+        if (!applied) break;
+        rating.counts[(int)applied->id]++;
+        rating.steps++;
+        if (applied->score > rating.score) rating.score = applied->score;
+        if (applied->tier > rating.maxTier) rating.maxTier = applied->tier;
+    }
+    Strategies::setStepMode(previous);
+
+    if (!grid.isComplete() && allowBacktrack && grid.isValid() && Strategies::backtrack(grid)) {
+        rating.counts[(int)StrategyId::Backtrack]++;
+        rating.score = BACKTRACK_SCORE;
+        rating.maxTier = 3;
+    }
+    rating.solved = grid.isComplete();
+    return rating.solved;
+}
+
+} // namespace Rater
@@ -0,0 +1,26 @@
+#pragma once
+#include <array>
+#include "strategies.h"
+#include "sudoku_grid.h"
+
+// 난이도 평가: 매 단계 가장 쉬운 전략부터 하나씩 적용하고 가장 어려운 단계로 점수를 매김
+namespace Rater {
+    const int STRATEGY_COUNT = (int)Strategies::StrategyId::Count;
+
+    struct Rating {
+        bool solved = false;
+        double score = 0.0;     // Sudoku Explainer 척도와 비슷한 점수
+        int maxTier = 0;        // 0 기본, 1 중급, 2 고급, 3 백트래킹
+        int steps = 0;
+        std::array<int, STRATEGY_COUNT> counts = {};
+    };
+
+    bool rate(const SudokuGrid& puzzle, Rating& rating, bool allowBacktrack = true);
+
+    // 기본 퍼즐이 받을 수 있는 점수 (사다리 점수, 허용하면 백트래킹 10.0) 중 하나라도 [minScore, maxScore] 안에 있는지
+    bool reachable(double minScore, double maxScore, bool allowBacktrack = true);
+
+    double score(Strategies::StrategyId id);
+    int tier(Strategies::StrategyId id);
+    const char* name(Strategies::StrategyId id);
+}
@@ -0,0 +1,371 @@
+#include "server.h"
+#include "batch.h"
+#include "corpus_reader.h"
+#include "solver.h"
+#include "solver_pool.h"
+#include "telemetry.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <afunix.h>
+#pragma comment(lib, "ws2_32.lib")
+typedef SOCKET socket_t;
+#define CLOSE_SOCKET closesocket
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+typedef int socket_t;
+#define INVALID_SOCKET (-1)
+#define CLOSE_SOCKET ::close
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace {
+
+const double METRICS_INTERVAL = 10;     // 초
+
+bool recvAll(socket_t s, char* buf, size_t size) {
+    while (size > 0) {
+        int n = recv(s, buf, (int)size, 0);
+        if (n <= 0) return false;
+        buf += n;
+        size -= (size_t)n;
+    }
+    return true;
+}
+
+bool sendAll(socket_t s, const char* buf, size_t size) {
+    while (size > 0) {
+        int n = send(s, buf, (int)size, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        buf += n;
+        size -= (size_t)n;
+    }
+    return true;
+}
+
+uint32_t readU32(const char* p) {
+    const unsigned char* u = (const unsigned char*)p;
+    return (uint32_t)u[0] | ((uint32_t)u[1] << 8) | ((uint32_t)u[2] << 16) | ((uint32_t)u[3] << 24);
+}
+
+void writeU32(uint32_t value, char* p) {
+    for (int i = 0; i < 4; i++) p[i] = (char)(value >> (8 * i));
+}
+
+// 응답 프레임 하나를 out 뒤에 추가
+void appendResponse(std::string& out, uint32_t id, uint8_t status, const char* grid) {
+    char frame[4 + SolverServer::RESPONSE_SIZE];
+    writeU32((uint32_t)SolverServer::RESPONSE_SIZE, frame);
+    writeU32(id, frame + 4);
+    frame[8] = (char)status;
+    memcpy(frame + 9, grid, 81);
+    out.append(frame, sizeof(frame));
+}
+
+} // namespace
+
+struct SolverServer::Connection {
+    socket_t sock;
+    std::mutex writeMtx;
+
+    explicit Connection(socket_t s) : sock(s) {}
+    ~Connection() { CLOSE_SOCKET(sock); }
+};
+
+SolverServer::SolverServer(const Options& opts) : options(opts), stopping(false), served(0) {
+    if (options.cacheBytes > 0) cache.reset(new SolutionCache(options.cacheBytes));
+}
+
+SolverServer::~SolverServer() { stop(); }
+
+bool SolverServer::start() {
+#ifdef _WIN32
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return false;
+#endif
+    if (options.tcpPort > 0) {
+        socket_t s = socket(AF_INET, SOCK_STREAM, 0);
+        if (s == INVALID_SOCKET) return false;
+        int one = 1;
+        setsockopt(s, SOL_SOCKET, SO_REUSEADDR, (const char*)&one, sizeof(one));
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons((uint16_t)options.tcpPort);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (bind(s, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(s, 128) != 0) {
+            fprintf(stderr, "TCP 포트 %d에 바인드할 수 없습니다\n", options.tcpPort);
+            CLOSE_SOCKET(s);
+            return false;
+        }
+        listeners.push_back((uintptr_t)s);
+    }
+    if (options.unixPath) {
+        socket_t s = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (s == INVALID_SOCKET) return false;
+        sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, options.unixPath, sizeof(addr.sun_path) - 1);
+#ifdef _WIN32
+        DeleteFileA(options.unixPath);
+#else
+        unlink(options.unixPath);
+#endif
+        if (bind(s, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(s, 128) != 0) {
+            fprintf(stderr, "소켓 %s에 바인드할 수 없습니다\n", options.unixPath);
+            CLOSE_SOCKET(s);
+            return false;
+        }
+        listeners.push_back((uintptr_t)s);
+    }
+    if (listeners.empty()) return false;
+
+    // 솔버는 워커마다 미리 만들어 두고 재사용
+    int threads = options.threads > 0 ? options.threads : (int)std::thread::hardware_concurrency();
+    if (threads <= 0) threads = 1;
+    for (int t = 0; t < threads; t++) {
+        contexts.emplace_back(new SolverContext(Strategies::SEARCH_SCRATCH_BYTES));
+        SudokuSolver& solver = contexts.back()->solver;
+        solver.setUseBacktrack(options.useBacktrack);
+        solver.setCache(cache.get());
+    }
+    for (auto& c : contexts) workers.emplace_back(&SolverServer::workerLoop, this, c.get());
+    startTime = std::chrono::steady_clock::now();
+    // 주기 보고가 없어도 지표 파일은 수집기가 읽도록 주기적으로 갱신
+    bool print = options.reportInterval > 0;
+    double interval = print ? options.reportInterval : options.metricsPath ? METRICS_INTERVAL : 0;
+    if (interval > 0) {
+        reporter.reset(new Telemetry::Reporter(interval, [this, print](double elapsed) { report(elapsed, print); }));
+    }
+    for (uintptr_t l : listeners) acceptors.emplace_back(&SolverServer::acceptLoop, this, l);
+    return true;
+}
+
+void SolverServer::stop() {
+    if (stopping.exchange(true)) return;
+    {
+        std::lock_guard<std::mutex> lock(connMtx);
+        connCv.notify_all();
+    }
+    for (uintptr_t l : listeners) {
+#ifdef _WIN32
+        shutdown((socket_t)l, SD_BOTH);
+#else
+        shutdown((socket_t)l, SHUT_RDWR);
+#endif
+        CLOSE_SOCKET((socket_t)l);
+    }
+    for (auto& t : acceptors) t.join();
+
+    // 읽기 스레드를 깨워 종료시킴
+    {
+        std::unique_lock<std::mutex> lock(connMtx);
+        for (auto& w : connections) {
+            if (auto c = w.lock()) {
+#ifdef _WIN32
+                shutdown(c->sock, SD_BOTH);
+#else
+                shutdown(c->sock, SHUT_RDWR);
+#endif
+            }
+        }
+        connCv.wait(lock, [this]() { return activeReaders == 0; });
+    }
+
+    queueCv.notify_all();
+    for (auto& t : workers) t.join();
+    if (reporter) reporter->stop();
+    if (!contexts.empty()) {
+        report(std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count(), false);
+    }
+#ifdef _WIN32
+    WSACleanup();
+#endif
+    if (options.unixPath) {
+#ifdef _WIN32
+        DeleteFileA(options.unixPath);
+#else
+        unlink(options.unixPath);
+#endif
+    }
+}
+
+void SolverServer::wait() {
+    std::unique_lock<std::mutex> lock(connMtx);
+    connCv.wait(lock, [this]() { return stopping.load(); });
+}
+
+void SolverServer::acceptLoop(uintptr_t listener) {
+    while (!stopping) {
+        socket_t s = accept((socket_t)listener, nullptr, nullptr);
+        if (s == INVALID_SOCKET) {
+            if (stopping) break;
+            continue;
+        }
+        int one = 1;
+        setsockopt(s, IPPROTO_TCP, TCP_NODELAY, (const char*)&one, sizeof(one));
+        auto conn = std::make_shared<Connection>(s);
+        {
+            std::lock_guard<std::mutex> lock(connMtx);
+            // 끊긴 연결 정리
+            size_t k = 0;
+            for (size_t i = 0; i < connections.size(); i++) {
+                if (!connections[i].expired()) connections[k++] = connections[i];
+            }
+            connections.resize(k);
+            connections.push_back(conn);
+            activeReaders++;
+        }
+        std::thread(&SolverServer::readLoop, this, conn).detach();
+    }
+}
+
+void SolverServer::readLoop(std::shared_ptr<Connection> conn) {
+    char header[4];
+    char body[REQUEST_SIZE];
+    while (!stopping && recvAll(conn->sock, header, 4)) {
+        if (readU32(header) != REQUEST_SIZE || !recvAll(conn->sock, body, REQUEST_SIZE)) break;
+
+        Request req;
+        req.conn = conn;
+        req.id = readU32(body);
+        uint32_t timeoutMs = readU32(body + 4);
+        req.hasDeadline = timeoutMs != 0;
+        req.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        memcpy(req.puzzle, body + 8, 81);
+
+        bool accepted = false;
+        {
+            std::lock_guard<std::mutex> lock(queueMtx);
+            if (queue.size() < options.maxQueue) {
+                queue.push_back(std::move(req));
+                accepted = true;
+            }
+        }
+        if (accepted) {
+            queueCv.notify_one();
+        } else {
+            std::string frame;
+            appendResponse(frame, readU32(body), BUSY, body + 8);
+            reply(*conn, frame.data(), frame.size());
+        }
+    }
+    conn.reset();
+    std::lock_guard<std::mutex> lock(connMtx);
+    activeReaders--;
+    connCv.notify_all();
+}
+
+void SolverServer::reply(Connection& conn, const char* frames, size_t size) {
+    std::lock_guard<std::mutex> lock(conn.writeMtx);
+    sendAll(conn.sock, frames, size);
+}
+
+void SolverServer::report(double elapsed, bool print) {
+    Telemetry::Snapshot snap;
+    for (auto& c : contexts) snap.add(c->metrics);
+    if (print) {
+        std::string line;
+        Telemetry::formatReport(snap, elapsed, (snap.total() - lastReported) / (elapsed - lastElapsed), line);
+        fprintf(stderr, "%s\n", line.c_str());
+        lastReported = snap.total();
+        lastElapsed = elapsed;
+    }
+    if (options.metricsPath && !Telemetry::writePrometheus(snap, elapsed, options.metricsPath)) {
+        fprintf(stderr, "지표 파일을 쓸 수 없습니다: %s\n", options.metricsPath);
+    }
+}
+
+void SolverServer::workerLoop(SolverContext* ctx) {
+    SolverContext& context = *ctx;
+    SudokuSolver& solver = context.solver;
+    Telemetry::Metrics& metrics = context.metrics;
+
+    std::vector<Request> batch;
+    batch.reserve(options.maxBatch);
+    // 배치 안의 응답을 연결별로 모아 한 번에 전송 (버퍼는 재사용)
+    std::vector<std::pair<Connection*, std::string>> outgoing;
+    size_t used = 0;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(queueMtx);
+            queueCv.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (queue.empty()) return;
+            while (!queue.empty() && (int)batch.size() < options.maxBatch) {
+                batch.push_back(std::move(queue.front()));
+                queue.pop_front();
+            }
+        }
+
+        auto respond = [&](const Request& req, uint8_t status, const char* grid) {
+            metrics.count(status == SOLVED ? Telemetry::Solved : status == UNSOLVED ? Telemetry::Unsolved
+                : status == INVALID ? Telemetry::Invalid : Telemetry::Timeout);
+            size_t k = 0;
+            while (k < used && outgoing[k].first != req.conn.get()) k++;
+            if (k == used) {
+                if (used == outgoing.size()) outgoing.emplace_back();
+                outgoing[used].first = req.conn.get();
+                outgoing[used].second.clear();
+                used++;
+            }
+            appendResponse(outgoing[k].second, req.id, status, grid);
+        };
+        // 묶음 안에서 시한이 지난 요청은 차례가 오기 전에 풀지 않고 시간 초과로 답함 (앞 요청을 푸는 동안 지난 것도)
+        auto expire = [&](size_t from) {
+            auto now = std::chrono::steady_clock::now();
+            for (size_t j = from; j < batch.size(); j++) {
+                if (batch[j].conn && batch[j].hasDeadline && now >= batch[j].deadline) {
+                    respond(batch[j], TIMEOUT, batch[j].puzzle);
+                    batch[j].conn.reset();
+                }
+            }
+        };
+
+        expire(0);
+        for (size_t i = 0; i < batch.size(); i++) {
+            Request& req = batch[i];
+            if (!req.conn) continue;
+            uint8_t status;
+            char grid[81];
+            auto now = std::chrono::steady_clock::now();
+            context.reset();
+            if (!CorpusReader::parse(req.puzzle, req.puzzle + 81, solver.getGrid())) {
+                status = INVALID;
+                memcpy(grid, req.puzzle, 81);
+            } else {
+                // 탐색도 시한에서 멈춤 (푼 데까지의 작업은 버림)
+                if (req.hasDeadline) solver.setDeadline(req.deadline);
+                else solver.clearDeadline();
+                status = solver.solve() ? SOLVED : UNSOLVED;
+                auto done = std::chrono::steady_clock::now();
+                metrics.recordLatency((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(done - now).count());
+                if (solver.usedBacktrack()) metrics.count(Telemetry::Backtracked);
+                if (solver.timedOut() || (req.hasDeadline && done >= req.deadline)) status = TIMEOUT;
+                if (status == TIMEOUT) memcpy(grid, req.puzzle, 81);
+                else Batch::formatGrid(solver.getGrid(), grid);
+            }
+            respond(req, status, grid);
+            expire(i + 1);
+        }
+
+        for (size_t k = 0; k < used; k++) reply(*outgoing[k].first, outgoing[k].second.data(), outgoing[k].second.size());
+        served += batch.size();
+        used = 0;
+        batch.clear();
+    }
+}
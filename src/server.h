@@ -0,0 +1,97 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "solution_cache.h"
+
+struct SolverContext;
+namespace Telemetry { class Reporter; }
+
+// 상주 솔버 서비스 (localhost TCP 또는 Unix 도메인 소켓)
+//
+// 프레임: [길이 uint32 LE][본문]
+//   요청 본문 89바이트: id uint32, 제한 시간 ms uint32 (0 = 없음), 퍼즐 81글자 ('.'/'0' = 빈칸)
+//   응답 본문 86바이트: id uint32, 상태 uint8, 그리드 81글자
+class SolverServer {
+public:
+    enum Status : uint8_t {
+        SOLVED = 0,
+        UNSOLVED = 1,
+        INVALID = 2,
+        TIMEOUT = 3,
+        BUSY = 4,
+    };
+
+    static const size_t REQUEST_SIZE = 89;
+    static const size_t RESPONSE_SIZE = 86;
+
+    struct Options {
+        int tcpPort = 0;                    // 127.0.0.1에만 바인드, 0이면 사용 안 함
+        const char* unixPath = nullptr;
+        int threads = 0;                    // 0이면 코어 수
+        int maxBatch = 64;                  // 워커가 한 번에 꺼내는 요청 수
+        size_t maxQueue = 65536;            // 넘치면 BUSY 응답
+        bool useBacktrack = false;
+        size_t cacheBytes = 0;
+        double reportInterval = 0;          // 초, 0이면 주기 보고 안 함 (stderr)
+        const char* metricsPath = nullptr;  // Prometheus 텍스트 파일 (보고할 때마다, 멈출 때 갱신)
+    };
+
+    explicit SolverServer(const Options& options);
+    ~SolverServer();
+    SolverServer(const SolverServer&) = delete;
+    SolverServer& operator=(const SolverServer&) = delete;
+
+    bool start();
+    void stop();
+    void wait();
+
+    uint64_t getServed() const { return served.load(); }
+
+private:
+    struct Connection;
+
+    struct Request {
+        std::shared_ptr<Connection> conn;
+        uint32_t id;
+        std::chrono::steady_clock::time_point deadline;
+        bool hasDeadline;
+        char puzzle[81];
+    };
+
+    void acceptLoop(uintptr_t listener);
+    void readLoop(std::shared_ptr<Connection> conn);
+    void workerLoop(SolverContext* context);
+    void report(double elapsed, bool print);
+    void reply(Connection& conn, const char* frames, size_t size);
+
+    Options options;
+    std::unique_ptr<SolutionCache> cache;
+    std::vector<uintptr_t> listeners;
+    std::vector<std::thread> acceptors;
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<SolverContext>> contexts;  // 워커별 (지표도 여기에)
+    std::unique_ptr<Telemetry::Reporter> reporter;
+    std::chrono::steady_clock::time_point startTime;
+    uint64_t lastReported = 0;
+    double lastElapsed = 0;
+
+    std::mutex queueMtx;
+    std::condition_variable queueCv;
+    std::deque<Request> queue;
+
+    std::mutex connMtx;
+    std::condition_variable connCv;
+    std::vector<std::weak_ptr<Connection>> connections;
+    int activeReaders = 0;
+
+    std::atomic<bool> stopping;
+    std::atomic<uint64_t> served;
+};
@@ -0,0 +1,389 @@
+#include "shard.h"
+#include "binary_format.h"
+#include "corpus_reader.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <sched.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace Shard {
+
+namespace {
+
+const size_t COPY_BYTES = 1u << 20;
+
+struct Worker {
+    uint64_t begin = 0;             // 텍스트: 바이트, 바이너리: 레코드
+    uint64_t end = 0;
+    uint64_t lineBase = 0;          // 텍스트: begin 앞의 줄 수
+    std::string outputPath;
+    std::string statsPath;
+    int firstCpu = 0;
+    int cpuCount = 0;
+#ifdef _WIN32
+    HANDLE process = nullptr;
+#else
+    pid_t pid = -1;
+#endif
+};
+
+std::string selfPath(const char* fallback) {
+#ifdef _WIN32
+    char buf[MAX_PATH];
+    DWORD n = GetModuleFileNameA(nullptr, buf, sizeof(buf));
+    if (n > 0 && n < sizeof(buf)) return std::string(buf, n);
+#elif defined(__linux__)
+    char buf[4096];
+    ssize_t n = readlink("/proc/self/exe", buf, sizeof(buf));
+    if (n > 0 && n < (ssize_t)sizeof(buf)) return std::string(buf, (size_t)n);
+#endif
+    return fallback ? fallback : "";
+}
+
+// stdout으로 출력할 때 조각 파일을 둘 곳
+std::string tempBase() {
+#ifdef _WIN32
+    char dir[MAX_PATH];
+    DWORD n = GetTempPathA(sizeof(dir), dir);
+    std::string base = n > 0 && n < sizeof(dir) ? std::string(dir, n) : std::string();
+    return base + "sudoku_shard_" + std::to_string(GetCurrentProcessId());
+#else
+    const char* dir = getenv("TMPDIR");
+    return std::string(dir && *dir ? dir : "/tmp") + "/sudoku_shard_" + std::to_string(getpid());
+#endif
+}
+
+#ifdef _WIN32
+// CommandLineToArgvW 규칙에 맞춰 인용
+void appendQuoted(std::string& cmd, const std::string& arg) {
+    if (!cmd.empty()) cmd += ' ';
+    if (!arg.empty() && arg.find_first_of(" \t\"") == std::string::npos) {
+        cmd += arg;
+        return;
+    }
+    cmd += '"';
+    size_t slashes = 0;
+    for (char c : arg) {
+        if (c == '\\') { slashes++; continue; }
+        cmd.append(c == '"' ? slashes * 2 + 1 : slashes, '\\');
+        slashes = 0;
+        cmd += c;
+    }
+    cmd.append(slashes * 2, '\\');
+    cmd += '"';
+}
+#endif
+
+bool spawn(Worker& w, const std::string& program, const std::vector<std::string>& args, bool pin) {
+#ifdef _WIN32
+    std::string cmd;
+    appendQuoted(cmd, program);
+    for (const std::string& a : args) appendQuoted(cmd, a);
+    STARTUPINFOA si = {};
+    si.cb = sizeof(si);
+    PROCESS_INFORMATION pi;
+    // 코어를 고정하려면 첫 명령 전에 해야 하므로 멈춘 채로 만듦
+    if (!CreateProcessA(program.c_str(), &cmd[0], nullptr, nullptr, TRUE, CREATE_SUSPENDED, nullptr, nullptr, &si, &pi)) {
+        return false;
+    }
+    if (pin) {
+        DWORD_PTR mask = 0;
+        for (int c = w.firstCpu; c < w.firstCpu + w.cpuCount && c < (int)sizeof(DWORD_PTR) * 8; c++) mask |= (DWORD_PTR)1 << c;
+        if (mask) SetProcessAffinityMask(pi.hProcess, mask);
+    }
+    ResumeThread(pi.hThread);
+    CloseHandle(pi.hThread);
+    w.process = pi.hProcess;
+    return true;
+#else
+    std::vector<char*> argv;
+    argv.push_back(const_cast<char*>(program.c_str()));
+    for (const std::string& a : args) argv.push_back(const_cast<char*>(a.c_str()));
+    argv.push_back(nullptr);
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c = w.firstCpu; c < w.firstCpu + w.cpuCount && c < CPU_SETSIZE; c++) CPU_SET(c, &set);
+#endif
+    fflush(nullptr);    // 버퍼에 남은 출력이 자식에서 다시 나가지 않도록
+    pid_t pid = fork();
+    if (pid < 0) return false;
+    if (pid == 0) {
+#ifdef __linux__
+        if (pin) sched_setaffinity(0, sizeof(set), &set);
+#endif
+        execvp(argv[0], argv.data());
+        _exit(127);
+    }
+    w.pid = pid;
+    return true;
+#endif
+}
+
+// 끝날 때까지 기다려 성공 여부를 돌려주고, 실패 이유를 reason에 씀
+bool wait(Worker& w, std::string& reason) {
+    char buf[64];
+#ifdef _WIN32
+    WaitForSingleObject(w.process, INFINITE);
+    DWORD code = 1;
+    GetExitCodeProcess(w.process, &code);
+    CloseHandle(w.process);
+    w.process = nullptr;
+    if (code == 0) return true;
+    snprintf(buf, sizeof(buf), "종료 코드 0x%lx", (unsigned long)code);
+#else
+    int status = 0;
+    while (waitpid(w.pid, &status, 0) < 0) {
+        if (errno != EINTR) { status = -1; break; }
+    }
+    w.pid = -1;
+    if (status >= 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0) return true;
+    if (status >= 0 && WIFSIGNALED(status)) snprintf(buf, sizeof(buf), "시그널 %d", WTERMSIG(status));
+    else if (status >= 0 && WIFEXITED(status)) snprintf(buf, sizeof(buf), "종료 코드 %d", WEXITSTATUS(status));
+    else snprintf(buf, sizeof(buf), "상태를 알 수 없음");
+#endif
+    reason = buf;
+    return false;
+}
+
+bool appendText(const std::string& path, FILE* out, std::vector<char>& buf) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    bool ok = true;
+    size_t n;
+    while ((n = fread(buf.data(), 1, buf.size(), f)) > 0) {
+        if (fwrite(buf.data(), 1, n, out) != n) { ok = false; break; }
+    }
+    if (ferror(f)) ok = false;
+    fclose(f);
+    return ok;
+}
+
+// 조각마다 헤더를 떼고 레코드를 이어 붙인 뒤 인덱스를 이어 붙임 (워커가 이미 파일 기준 줄 번호로 씀)
+bool mergeBinary(const std::vector<Worker>& workers, FILE* out) {
+    std::vector<std::unique_ptr<BinaryFormat::Reader>> parts;
+    BinaryFormat::Header merged;
+    merged.recordCount = 0;
+    for (const Worker& w : workers) {
+        parts.emplace_back(new BinaryFormat::Reader());
+        if (!parts.back()->open(w.outputPath.c_str())) return false;
+        const BinaryFormat::Header& h = parts.back()->header();
+        merged.flags = h.flags;
+        merged.recordSize = h.recordSize;
+        merged.recordCount += h.recordCount;
+    }
+    bool hasIndex = (merged.flags & BinaryFormat::HAS_INDEX) != 0;
+    if (hasIndex) merged.indexOffset = BinaryFormat::HEADER_SIZE + merged.recordCount * merged.recordSize;
+    unsigned char h[BinaryFormat::HEADER_SIZE];
+    BinaryFormat::writeHeader(merged, h);
+    if (fwrite(h, 1, sizeof(h), out) != sizeof(h)) return false;
+
+    for (const auto& part : parts) {
+        size_t bytes = (size_t)(part->count() * part->header().recordSize);
+        if (bytes && fwrite(part->record(0), 1, bytes, out) != bytes) return false;
+    }
+    if (!hasIndex) return true;
+    unsigned char line[8];
+    for (size_t i = 0; i < parts.size(); i++) {
+        for (uint64_t r = 0; r < parts[i]->count(); r++) {
+            BinaryFormat::writeU64(parts[i]->sourceLine(r), line);
+            if (fwrite(line, 1, 8, out) != 8) return false;
+        }
+    }
+    return true;
+}
+
+void addStats(Batch::Stats& to, const Batch::Stats& from) {
+    to.total += from.total;
+    to.solved += from.solved;
+    to.unsolved += from.unsolved;
+    to.invalid += from.invalid;
+    to.cacheHits += from.cacheHits;
+    to.cacheMisses += from.cacheMisses;
+    to.cacheEvictions += from.cacheEvictions;
+    to.backtracks += from.backtracks;
+    to.lines += from.lines;
+    to.verified += from.verified;
+    to.mismatches += from.mismatches;
+    to.latencyMax = std::max(to.latencyMax, from.latencyMax);
+}
+
+} // namespace
+
+bool run(const Options& options, Batch::Stats& stats) {
+    // 범위만 정하면 되므로 매핑해서 줄 경계(바이너리는 레코드 수)만 확인
+    CorpusReader reader;
+    if (!options.inputPath || !reader.open(options.inputPath)) {
+        fprintf(stderr, "다중 프로세스 처리는 일반 파일 입력만 지원합니다: %s\n", options.inputPath ? options.inputPath : "");
+        return false;
+    }
+    BinaryFormat::Reader binaryInput;
+    bool binary = BinaryFormat::isBinary(reader.data(), reader.size());
+    if (binary && !binaryInput.attach(reader.data(), reader.size())) {
+        fprintf(stderr, "바이너리 헤더가 올바르지 않습니다: %s\n", options.inputPath);
+        return false;
+    }
+    uint64_t inputEnd = binary ? binaryInput.count() : reader.size();
+
+    int processes = std::max(1, options.processes);
+    int cores = std::max(1, (int)std::thread::hardware_concurrency());
+    int perProcess = std::max(1, cores / processes);
+    int threads = options.threads > 0 ? options.threads : perProcess;
+    std::string base = options.outputPath ? std::string(options.outputPath) : tempBase();
+
+    std::vector<Worker> workers(processes);
+    uint64_t prev = 0;
+    for (int i = 0; i < processes; i++) {
+        Worker& w = workers[i];
+        uint64_t end = i + 1 == processes ? inputEnd : inputEnd * (uint64_t)(i + 1) / (uint64_t)processes;
+        // 텍스트는 다음 줄 시작으로 밀어 줄이 두 조각에 걸치지 않게 함
+        if (!binary) {
+            end = (uint64_t)(CorpusReader::lineStart(reader.data(), reader.data() + inputEnd, reader.data() + end) - reader.data());
+        }
+        w.begin = prev;
+        w.end = std::max(end, prev);
+        prev = w.end;
+        if (!binary && i + 1 < processes) {
+            workers[i + 1].lineBase = w.lineBase + (uint64_t)std::count(reader.data() + w.begin, reader.data() + w.end, '\n');
+        }
+        w.outputPath = base + ".part" + std::to_string(i);
+        w.statsPath = w.outputPath + ".stats";
+        w.firstCpu = (i * perProcess) % cores;
+        w.cpuCount = perProcess;
+    }
+    reader.close();
+
+    std::string program = selfPath(options.program);
+    bool ok = true;
+    int started = 0;
+    for (Worker& w : workers) {
+        std::vector<std::string> args = options.args;
+        args.push_back(options.inputPath);
+        args.push_back("-o");
+        args.push_back(w.outputPath);
+        args.push_back("-t");
+        args.push_back(std::to_string(threads));
+        args.push_back("--range");
+        args.push_back(std::to_string(w.begin) + ":" + std::to_string(w.end));
+        args.push_back("--stats");
+        args.push_back(w.statsPath);
+        if (w.lineBase) {
+            args.push_back("--line-base");
+            args.push_back(std::to_string(w.lineBase));
+        }
+        remove(w.statsPath.c_str());
+        if (!spawn(w, program, args, options.pin)) {
+            fprintf(stderr, "워커 프로세스를 시작할 수 없습니다: %s\n", program.c_str());
+            ok = false;
+            break;
+        }
+        started++;
+    }
+
+    // 모두 기다린 뒤 통계를 합침. 죽은 조각은 범위를 알려 문제 입력을 좁힐 수 있게 함
+    for (int i = 0; i < started; i++) {
+        Worker& w = workers[i];
+        std::string reason;
+        Batch::Stats part;
+        bool done = wait(w, reason);
+        if (done && !readStats(w.statsPath.c_str(), part)) {
+            done = false;
+            reason = "통계 파일 없음";
+        }
+        if (!done) {
+            fprintf(stderr, "조각 %d (%s %llu-%llu) 실패: %s, 부분 출력 %s\n", i, binary ? "레코드" : "바이트",
+                (unsigned long long)w.begin, (unsigned long long)w.end, reason.c_str(), w.outputPath.c_str());
+            ok = false;
+            continue;
+        }
+        addStats(stats, part);
+    }
+    if (!ok) return false;
+
+    FILE* out = options.outputPath ? fopen(options.outputPath, "wb") : stdout;
+    if (!out) {
+        fprintf(stderr, "출력 파일을 열 수 없습니다: %s\n", options.outputPath);
+        return false;
+    }
+#ifdef _WIN32
+    if (out == stdout && options.outputFormat == Batch::Format::Binary) _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    if (options.outputFormat == Batch::Format::Binary) ok = mergeBinary(workers, out);
+    else {
+        std::vector<char> buf(COPY_BYTES);
+        for (const Worker& w : workers) {
+            if (!appendText(w.outputPath, out, buf)) { ok = false; break; }
+        }
+    }
+    if (out != stdout) { if (fclose(out) != 0) ok = false; }
+    else if (fflush(out) != 0) ok = false;
+    if (!ok) {
+        fprintf(stderr, "조각 출력을 합칠 수 없습니다: %s\n", options.outputPath ? options.outputPath : "stdout");
+        return false;
+    }
+    for (const Worker& w : workers) {
+        remove(w.outputPath.c_str());
+        remove(w.statsPath.c_str());
+    }
+    return true;
+}
+
+bool writeStats(const char* path, const Batch::Stats& stats) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    fprintf(f, "total %llu\nsolved %llu\nunsolved %llu\ninvalid %llu\n",
+        (unsigned long long)stats.total, (unsigned long long)stats.solved,
+        (unsigned long long)stats.unsolved, (unsigned long long)stats.invalid);
+    fprintf(f, "cache_hits %llu\ncache_misses %llu\ncache_evictions %llu\n",
+        (unsigned long long)stats.cacheHits, (unsigned long long)stats.cacheMisses,
+        (unsigned long long)stats.cacheEvictions);
+    fprintf(f, "backtracks %llu\nlines %llu\nlatency_max %llu\n",
+        (unsigned long long)stats.backtracks, (unsigned long long)stats.lines,
+        (unsigned long long)stats.latencyMax);
+    fprintf(f, "verified %llu\nmismatches %llu\n",
+        (unsigned long long)stats.verified, (unsigned long long)stats.mismatches);
+    return fclose(f) == 0;
+}
+
+bool readStats(const char* path, Batch::Stats& stats) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    char name[32];
+    unsigned long long value;
+    int fields = 0;
+    while (fscanf(f, "%31s %llu", name, &value) == 2) {
+        fields++;
+        if (!strcmp(name, "total")) stats.total = (size_t)value;
+        else if (!strcmp(name, "solved")) stats.solved = (size_t)value;
+        else if (!strcmp(name, "unsolved")) stats.unsolved = (size_t)value;
+        else if (!strcmp(name, "invalid")) stats.invalid = (size_t)value;
+        else if (!strcmp(name, "cache_hits")) stats.cacheHits = value;
+        else if (!strcmp(name, "cache_misses")) stats.cacheMisses = value;
+        else if (!strcmp(name, "cache_evictions")) stats.cacheEvictions = value;
+        else if (!strcmp(name, "backtracks")) stats.backtracks = value;
+        else if (!strcmp(name, "lines")) stats.lines = value;
+        else if (!strcmp(name, "latency_max")) stats.latencyMax = value;
+        else if (!strcmp(name, "verified")) stats.verified = value;
+        else if (!strcmp(name, "mismatches")) stats.mismatches = value;
+        else fields--;
+    }
+    fclose(f);
+    return fields > 0;
+}
+
+} // namespace Shard
@@ -0,0 +1,28 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "batch.h"
+
+// 큰 입력을 바이트 범위(바이너리는 레코드 범위)로 나눠 여러 프로세스에서 처리하고 결과를 합침.
+// 코어가 많은 장비에서 한 프로세스의 거대한 스레드 풀이 겪는 할당기 경합과 NUMA 간 접근을 피하고,
+// 어느 조각에서 프로세스가 죽어도 다른 조각은 끝까지 처리됨
+namespace Shard {
+    struct Options {
+        const char* program = nullptr;      // 자기 실행 파일 (argv[0], 찾을 수 없을 때만 씀)
+        const char* inputPath = nullptr;    // 매핑할 수 있는 파일만
+        const char* outputPath = nullptr;   // nullptr이면 stdout
+        int processes = 1;
+        int threads = 0;                    // 프로세스당 스레드 수, 0이면 코어 수 / 프로세스 수
+        bool pin = false;                   // 프로세스마다 겹치지 않는 코어 묶음에 고정
+        Batch::Format outputFormat = Batch::Format::Text;
+        std::vector<std::string> args;      // 워커에 그대로 넘길 명령과 옵션 (입력, -o, -t 제외)
+    };
+
+    // 조각을 모두 처리해 입력 순서대로 합친 출력과 합친 통계를 만듦.
+    // 실패한 조각이 있으면 그 범위를 알리고 조각 파일을 남긴 채 false
+    bool run(const Options& options, Batch::Stats& stats);
+
+    // 워커가 통계를 넘기는 파일 ("이름 값" 줄)
+    bool writeStats(const char* path, const Batch::Stats& stats);
+    bool readStats(const char* path, Batch::Stats& stats);
+}
@@ -0,0 +1,118 @@
+#include "solution_cache.h"
+
+namespace {
+
+// 항목 하나의 대략적인 메모리 (LRU 노드 + 해시 노드 + 버킷)
+const size_t ENTRY_BYTES = 41 * 3 + 6 * sizeof(void*);
+
+Canonical::Transform identityTransform() {
+    Canonical::Transform t;
+    for (int i = 0; i < 9; i++) { t.rows[i] = (uint8_t)i; t.cols[i] = (uint8_t)i; }
+    for (int d = 0; d <= 9; d++) t.digits[d] = (uint8_t)d;
+    return t;
+}
+
+} // namespace
+
+size_t SolutionCache::PackedHash::operator()(const Packed& p) const {
+    uint64_t h = 1469598103934665603ull;
+    for (uint8_t b : p) { h ^= b; h *= 1099511628211ull; }
+    return (size_t)(h ^ (h >> 32));
+}
+
+SolutionCache::SolutionCache(size_t maxBytes, KeyMode mode, int shardCount)
+    : keyMode(mode), shardCount(shardCount > 0 ? shardCount : 1) {
+    shards.reset(new Shard[this->shardCount]);
+    shardBytes = maxBytes / this->shardCount;
+}
+
+SolutionCache::Packed SolutionCache::pack(const Canonical::Form& form) {
+    Packed p;
+    p.fill(0);
+    for (int i = 0; i < 81; i++) p[i >> 1] |= (uint8_t)(form[i] << ((i & 1) * 4));
+    return p;
+}
+
+void SolutionCache::unpack(const Packed& packed, Canonical::Form& form) {
+    for (int i = 0; i < 81; i++) form[i] = (packed[i >> 1] >> ((i & 1) * 4)) & 0xF;
+}
+
+SolutionCache::Shard& SolutionCache::shardFor(const Packed& key) {
+    return shards[(PackedHash()(key) >> 7) % (size_t)shardCount];
+}
+
+void SolutionCache::makeKey(const SudokuGrid& puzzle, Key& key) const {
+    if (keyMode == KeyMode::Canonical) {
+        key.form = Canonical::canonicalize(puzzle, &key.transform);
+    } else {
+        key.form = Canonical::fromGrid(puzzle);
+        key.transform = identityTransform();
+    }
+}
+
+bool SolutionCache::lookup(const Key& key, Canonical::Form& solution) {
+    Packed packed = pack(key.form);
+    Shard& shard = shardFor(packed);
+    Packed stored;
+    {
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        auto it = shard.map.find(packed);
+        if (it == shard.map.end()) { shard.misses++; return false; }
+        shard.hits++;
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        stored = it->second->solution;
+    }
+    Canonical::Form canonical;
+    unpack(stored, canonical);
+    solution = Canonical::invert(canonical, key.transform);
+    return true;
+}
+
+void SolutionCache::insert(const Key& key, const SudokuGrid& solution) {
+    if (shardBytes < ENTRY_BYTES) return;
+    Packed packed = pack(key.form);
+    Packed value = pack(Canonical::apply(Canonical::fromGrid(solution), key.transform));
+    Shard& shard = shardFor(packed);
+
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    auto it = shard.map.find(packed);
+    if (it != shard.map.end()) {
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        return;
+    }
+    while (shard.bytes + ENTRY_BYTES > shardBytes && !shard.lru.empty()) {
+        shard.map.erase(shard.lru.back().key);
+        shard.lru.pop_back();
+        shard.bytes -= ENTRY_BYTES;
+        shard.evictions++;
+    }
+    shard.lru.push_front({ packed, value });
+    shard.map.emplace(packed, shard.lru.begin());
+    shard.bytes += ENTRY_BYTES;
+    shard.insertions++;
+}
+
+SolutionCache::Stats SolutionCache::getStats() const {
+    Stats s;
+    for (int i = 0; i < shardCount; i++) {
+        Shard& shard = shards[i];
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        s.hits += shard.hits;
+        s.misses += shard.misses;
+        s.insertions += shard.insertions;
+        s.evictions += shard.evictions;
+        s.entries += shard.lru.size();
+        s.bytes += shard.bytes;
+    }
+    return s;
+}
+
+void SolutionCache::clear() {
+    for (int i = 0; i < shardCount; i++) {
+        Shard& shard = shards[i];
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        shard.map.clear();
+        shard.lru.clear();
+        shard.bytes = 0;
+    }
+}
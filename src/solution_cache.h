@@ -0,0 +1,74 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include "canonical.h"
+#include "sudoku_grid.h"
+
+// SudokuSolver::solve 앞단의 해답 캐시 (샤드별 LRU, 바이트 단위 용량 제한)
+class SolutionCache {
+public:
+    enum class KeyMode {
+        Raw,        // 퍼즐 그대로
+        Canonical,  // 대칭 표준형 (변형된 퍼즐도 적중)
+    };
+
+    struct Key {
+        Canonical::Form form;
+        Canonical::Transform transform;     // 원본 → 표준형
+    };
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t insertions = 0;
+        uint64_t evictions = 0;
+        size_t entries = 0;
+        size_t bytes = 0;
+    };
+
+    explicit SolutionCache(size_t maxBytes, KeyMode mode = KeyMode::Canonical, int shardCount = 16);
+
+    KeyMode getKeyMode() const { return keyMode; }
+
+    void makeKey(const SudokuGrid& puzzle, Key& key) const;
+    // 적중하면 원본 방향의 해답을 solution에 채움
+    bool lookup(const Key& key, Canonical::Form& solution);
+    void insert(const Key& key, const SudokuGrid& solution);
+
+    Stats getStats() const;
+    void clear();
+
+private:
+    typedef std::array<uint8_t, 41> Packed;     // 칸당 4비트
+
+    struct PackedHash {
+        size_t operator()(const Packed& p) const;
+    };
+
+    struct Entry {
+        Packed key;
+        Packed solution;    // 표준형 방향
+    };
+
+    struct Shard {
+        std::mutex mtx;
+        std::list<Entry> lru;   // 앞쪽이 최근 사용
+        std::unordered_map<Packed, std::list<Entry>::iterator, PackedHash> map;
+        size_t bytes = 0;
+        uint64_t hits = 0, misses = 0, insertions = 0, evictions = 0;
+    };
+
+    static Packed pack(const Canonical::Form& form);
+    static void unpack(const Packed& packed, Canonical::Form& form);
+    Shard& shardFor(const Packed& key);
+
+    KeyMode keyMode;
+    size_t shardBytes;
+    std::unique_ptr<Shard[]> shards;
+    int shardCount;
+};
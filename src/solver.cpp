@@ -1,39 +1,75 @@
 #include "solver.h"
+#include "solution_cache.h"
 #include "strategies.h"
+#include "trace.h"
 
-SudokuSolver::SudokuSolver() : useBacktrack(false) { reset(); }
+SudokuSolver::SudokuSolver() : useBacktrack(false), strategies(ALL_STRATEGIES), cache(nullptr), scratch(nullptr), backtracked(false),
+    hasDeadline(false), expired(false) { reset(); }
 
 void SudokuSolver::reset() { grid.reset(); }
 
 bool SudokuSolver::solve() {
+    backtracked = false;
+    expired = false;
+    // 캐시 적중 시 전략 파이프라인을 건너뜀 (표준형은 기본 퍼즐의 대칭에서만 성립)
+    SolutionCache* cache = grid.getVariant().kind() == Variant::Kind::Classic ? this->cache : nullptr;
+    SolutionCache::Key key;
+    if (cache) {
+        cache->makeKey(grid, key);
+        Canonical::Form solution;
+        if (cache->lookup(key, solution)) {
+            for (int i = 0; i < 9; i++)
+                for (int j = 0; j < 9; j++)
+                    if (grid.getValue(i, j) == 0) grid.setCell(i, j, solution[i * 9 + j]);
+            return true;
+        }
+    }
+
     grid.updateCandidates();
     
+    using Id = Strategies::StrategyId;
+    auto on = [this](Id id) { return (strategies >> (int)id & 1) != 0; };
     bool progress = true;
     while (progress && !grid.isComplete()) {
+        if (hasDeadline && std::chrono::steady_clock::now() >= deadline) {
+            expired = true;
+            return false;
+        }
         progress = false;
+        SUDOKU_TRACE_STEP();
         
         // 기본 전략
-        if (Strategies::nakedSingles(grid)) { progress = true; continue; }
-        if (Strategies::hiddenSingles(grid)) { progress = true; continue; }
+        if (on(Id::NakedSingle) && Strategies::nakedSingles(grid)) { progress = true; continue; }
+        if (on(Id::HiddenSingle) && Strategies::hiddenSingles(grid)) { progress = true; continue; }
+        if (on(Id::KillerCage) && Strategies::killerCages(grid)) { progress = true; continue; }
         
         // 중급 전략
-        if (Strategies::nakedPairs(grid)) { progress = true; continue; }
-        if (Strategies::nakedTriples(grid)) { progress = true; continue; }
-        if (Strategies::hiddenPairs(grid)) { progress = true; continue; }
-        if (Strategies::hiddenTriples(grid)) { progress = true; continue; }
-        if (Strategies::pointingPairs(grid)) { progress = true; continue; }
-        if (Strategies::boxLineReduction(grid)) { progress = true; continue; }
+        if (on(Id::NakedPair) && Strategies::nakedPairs(grid)) { progress = true; continue; }
+        if (on(Id::NakedTriple) && Strategies::nakedTriples(grid)) { progress = true; continue; }
+        if (on(Id::HiddenPair) && Strategies::hiddenPairs(grid)) { progress = true; continue; }
+        if (on(Id::HiddenTriple) && Strategies::hiddenTriples(grid)) { progress = true; continue; }
+        if (on(Id::PointingPair) && Strategies::pointingPairs(grid)) { progress = true; continue; }
+        if (on(Id::BoxLineReduction) && Strategies::boxLineReduction(grid)) { progress = true; continue; }
         
         // 고급 전략
-        if (Strategies::xWing(grid)) { progress = true; continue; }
-        if (Strategies::swordfish(grid)) { progress = true; continue; }
-        if (Strategies::yWing(grid)) { progress = true; continue; }
+        if (on(Id::XWing) && Strategies::xWing(grid)) { progress = true; continue; }
+        if (on(Id::Swordfish) && Strategies::swordfish(grid)) { progress = true; continue; }
+        if (on(Id::YWing) && Strategies::yWing(grid)) { progress = true; continue; }
+        if (on(Id::ForcingChain) && Strategies::forcingChains(grid)) { progress = true; continue; }
     }
     
     // 백트래킹 옵션
-    if (!grid.isComplete() && useBacktrack) {
-        return Strategies::backtrack(grid);
+    bool solved = grid.isComplete();
+    if (!solved && useBacktrack) {
+        backtracked = true;
+        if (hasDeadline) Strategies::setSearchDeadline(deadline);
+        solved = scratch ? Strategies::backtrack(grid, *scratch) : Strategies::backtrack(grid);
+        if (hasDeadline) {
+            Strategies::clearSearchDeadline();
+            expired = Strategies::getSearchStats().expired;
+        }
     }
     
-    return grid.isComplete();
+    if (solved && cache) cache->insert(key, grid);
+    return solved;
 }
@@ -1,10 +1,22 @@
 #pragma once
+#include <chrono>
+#include <cstdint>
 #include "sudoku_grid.h"
 
+class Arena;
+class SolutionCache;
+
 class SudokuSolver {
 private:
     SudokuGrid grid;
     bool useBacktrack;
+    uint32_t strategies;
+    SolutionCache* cache;
+    Arena* scratch;
+    bool backtracked;
+    bool hasDeadline;
+    bool expired;
+    std::chrono::steady_clock::time_point deadline;
 
 public:
     SudokuSolver();
@@ -16,5 +28,25 @@ public:
     void setUseBacktrack(bool use) { useBacktrack = use; }
     bool getUseBacktrack() const { return useBacktrack; }
     
+    // 쓸 논리 전략 (비트 = 1 << StrategyId, Backtrack 비트는 무시하고 setUseBacktrack을 따름)
+    static const uint32_t ALL_STRATEGIES = 0xFFFFFFFFu;
+    void setStrategies(uint32_t mask) { strategies = mask; }
+    uint32_t getStrategies() const { return strategies; }
+    
+    // 여러 솔버가 공유할 수 있는 해답 캐시 (nullptr이면 사용 안 함)
+    void setCache(SolutionCache* c) { cache = c; }
+    SolutionCache* getCache() const { return cache; }
+    
+    // 백트래킹 탐색 메모리를 잡을 스크래치 (nullptr이면 스레드별 기본값)
+    void setScratch(Arena* a) { scratch = a; }
+    
+    // 지나면 전략 단계 사이와 백트래킹 탐색 중에 멈춤 (solve()는 false, timedOut()은 true)
+    void setDeadline(std::chrono::steady_clock::time_point d) { deadline = d; hasDeadline = true; }
+    void clearDeadline() { hasDeadline = false; }
+    
     bool solve();
+    // 마지막 solve()가 시한을 넘겨 멈췄는지
+    bool timedOut() const { return expired; }
+    // 마지막 solve()가 논리 전략으로 못 풀어 백트래킹으로 넘어갔는지
+    bool usedBacktrack() const { return backtracked; }
 };
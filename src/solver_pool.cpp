@@ -0,0 +1,36 @@
+#include "solver_pool.h"
+
+SolverContext::SolverContext(size_t scratchBytes) : scratch(scratchBytes) {
+    solver.setScratch(&scratch);
+}
+
+SolverPool::SolverPool(int count, const Config& config) {
+    if (count < 1) count = 1;
+    contexts.reserve(count);
+    idle.reserve(count);
+    for (int i = 0; i < count; i++) {
+        std::unique_ptr<SolverContext> ctx(new SolverContext(config.scratchBytes));
+        if (config.variant) ctx->solver.getGrid().setVariant(*config.variant);
+        ctx->solver.setUseBacktrack(config.useBacktrack);
+        ctx->solver.setCache(config.cache);
+        if (config.traceCapacity > 0) ctx->recorder.reset(new Trace::Recorder(config.traceCapacity));
+        idle.push_back(ctx.get());
+        contexts.push_back(std::move(ctx));
+    }
+}
+
+SolverContext& SolverPool::acquire() {
+    std::unique_lock<std::mutex> lock(mtx);
+    cv.wait(lock, [&]() { return !idle.empty(); });
+    SolverContext* ctx = idle.back();
+    idle.pop_back();
+    return *ctx;
+}
+
+void SolverPool::release(SolverContext& context) {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        idle.push_back(&context);   // reserve해 둔 용량 안이라 할당 없음
+    }
+    cv.notify_one();
+}
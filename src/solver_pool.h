@@ -0,0 +1,74 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "arena.h"
+#include "solver.h"
+#include "strategies.h"
+#include "telemetry.h"
+#include "trace.h"
+#include "variant.h"
+
+// 배치 작업이 돌려 쓰는 풀이 상태: 솔버, 고정 크기 스크래치, 단계 기록기, 줄마다 바뀌는 변형 배치.
+// 모두 만들 때 한 번만 할당하고, 퍼즐 사이의 reset()은 O(1)
+struct SolverContext {
+    SudokuSolver solver;
+    Arena scratch;
+    std::unique_ptr<Trace::Recorder> recorder;  // 기록하지 않으면 nullptr
+    Variant lineVariant;                        // 직소/킬러: 줄에서 읽은 배치
+    Telemetry::Metrics metrics;                 // 빌린 스레드만 기록, reset()해도 누적
+    SudokuGrid puzzle;                          // 차등 검증: 풀기 전 퍼즐과 기준 엔진의 결과
+    SudokuGrid reference;
+
+    explicit SolverContext(size_t scratchBytes);
+    // 그리드와 스크래치만 비움 (변형, 옵션, 기록기는 유지)
+    void reset() {
+        solver.reset();
+        scratch.reset();
+    }
+};
+
+class SolverPool {
+public:
+    struct Config {
+        const Variant* variant = nullptr;       // nullptr이면 기본 퍼즐
+        bool useBacktrack = false;
+        SolutionCache* cache = nullptr;         // 모든 컨텍스트가 공유
+        size_t traceCapacity = 0;               // 0이면 기록기 없음
+        size_t scratchBytes = Strategies::SEARCH_SCRATCH_BYTES;
+    };
+
+    SolverPool(int count, const Config& config);
+    SolverPool(const SolverPool&) = delete;
+    SolverPool& operator=(const SolverPool&) = delete;
+
+    // 쉬는 컨텍스트를 빌림 (없으면 반납될 때까지 기다림)
+    SolverContext& acquire();
+    void release(SolverContext& context);
+
+    // 범위를 벗어나면 반납
+    class Lease {
+    public:
+        explicit Lease(SolverPool& p) : pool(p), context(p.acquire()) {}
+        ~Lease() { pool.release(context); }
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        SolverContext& operator*() const { return context; }
+        SolverContext* operator->() const { return &context; }
+    private:
+        SolverPool& pool;
+        SolverContext& context;
+    };
+
+    int size() const { return (int)contexts.size(); }
+    // 주기 보고용 (metrics는 빌려 쓰는 중에도 읽을 수 있음)
+    const SolverContext& context(int i) const { return *contexts[i]; }
+
+private:
+    std::vector<std::unique_ptr<SolverContext>> contexts;
+    std::vector<SolverContext*> idle;
+    std::mutex mtx;
+    std::condition_variable cv;
+};
@@ -1,9 +1,30 @@
 #include "strategies.h"
-#include <vector>
+#include "trace.h"
+#include <algorithm>
+#include <bitset>
 #include <array>
 
 namespace Strategies {
 
+namespace {
+// 한 번에 패턴 하나만 적용하고 돌아가는 모드 (난이도 평가용)
+thread_local bool stepMode = false;
+
+// 칸 확정 / 후보 갱신 (추적 빌드에서는 기록도 남김)
+inline void place(SudokuGrid& grid, StrategyId id, int row, int col, int num) {
+    SUDOKU_TRACE(id, Trace::Kind::Place, row, col, 1 << (num - 1));
+    grid.setCell(row, col, num);
+}
+
+inline void eliminate(SudokuGrid& grid, StrategyId id, int row, int col, int cand) {
+    SUDOKU_TRACE(id, Trace::Kind::Eliminate, row, col, grid.getCandidates(row, col) & ~cand);
+    grid.setCandidates(row, col, cand);
+}
+}
+
+void setStepMode(bool enabled) { stepMode = enabled; }
+bool getStepMode() { return stepMode; }
+
 bool nakedSingles(SudokuGrid& grid) {
     bool progress = false;
     for (int i = 0; i < 9; i++) {
@@ -12,8 +33,9 @@ bool nakedSingles(SudokuGrid& grid) {
                 int cand = grid.getCandidates(i, j);
                 int num = 1;
                 while (!(cand & 1)) { cand >>= 1; num++; }
-                grid.setCell(i, j, num);
+                place(grid, StrategyId::NakedSingle, i, j, num);
                 progress = true;
+                if (stepMode) return true;
             }
         }
     }
@@ -22,46 +44,18 @@ bool nakedSingles(SudokuGrid& grid) {
 
 bool hiddenSingles(SudokuGrid& grid) {
     bool progress = false;
-    // 행
-    for (int row = 0; row < 9; row++) {
+    const Variant& v = grid.getVariant();
+    // 행, 열, 영역, 변형 유닛 순
+    for (int u = 0; u < v.unitCount(); u++) {
+        const uint8_t* cells = v.unit(u);
         for (int num = 1; num <= 9; num++) {
             int bit = 1 << (num - 1);
-            if (grid.getRowMask(row) & bit) continue;
-            int possCol = -1, cnt = 0;
-            for (int col = 0; col < 9 && cnt <= 1; col++) {
-                if (grid.getCandidates(row, col) & bit) { possCol = col; cnt++; }
-            }
-            if (cnt == 1) { grid.setCell(row, possCol, num); progress = true; }
-        }
-    }
-    // 열
-    for (int col = 0; col < 9; col++) {
-        for (int num = 1; num <= 9; num++) {
-            int bit = 1 << (num - 1);
-            if (grid.getColMask(col) & bit) continue;
-            int possRow = -1, cnt = 0;
-            for (int row = 0; row < 9 && cnt <= 1; row++) {
-                if (grid.getCandidates(row, col) & bit) { possRow = row; cnt++; }
-            }
-            if (cnt == 1) { grid.setCell(possRow, col, num); progress = true; }
-        }
-    }
-    // 박스
-    for (int br = 0; br < 3; br++) {
-        for (int bc = 0; bc < 3; bc++) {
-            for (int num = 1; num <= 9; num++) {
-                int bit = 1 << (num - 1);
-                if (grid.getBoxMask(br * 3 + bc) & bit) continue;
-                int pr = -1, pc = -1, cnt = 0;
-                for (int i = 0; i < 3 && cnt <= 1; i++) {
-                    for (int j = 0; j < 3 && cnt <= 1; j++) {
-                        if (grid.getCandidates(br * 3 + i, bc * 3 + j) & bit) { 
-                            pr = br * 3 + i; pc = bc * 3 + j; cnt++; 
-                        }
-                    }
-                }
-                if (cnt == 1) { grid.setCell(pr, pc, num); progress = true; }
+            if (grid.getUnitMask(u) & bit) continue;
+            int pos = -1, cnt = 0;
+            for (int k = 0; k < 9 && cnt <= 1; k++) {
+                if (grid.getCandidates(cells[k] / 9, cells[k] % 9) & bit) { pos = cells[k]; cnt++; }
             }
+            if (cnt == 1) { place(grid, StrategyId::HiddenSingle, pos / 9, pos % 9, num); progress = true; if (stepMode) return true; }
         }
     }
     return progress;
@@ -69,75 +63,23 @@ bool hiddenSingles(SudokuGrid& grid) {
 
 bool nakedPairs(SudokuGrid& grid) {
     bool progress = false;
-    // 행
-    for (int row = 0; row < 9; row++) {
-        for (int c1 = 0; c1 < 8; c1++) {
-            if (grid.getValue(row, c1) != 0 || SudokuGrid::countBits(grid.getCandidates(row, c1)) != 2) continue;
-            for (int c2 = c1 + 1; c2 < 9; c2++) {
-                if (grid.getCandidates(row, c1) == grid.getCandidates(row, c2)) {
-                    int pair = grid.getCandidates(row, c1);
-                    for (int c = 0; c < 9; c++) {
-                        if (c != c1 && c != c2 && grid.getValue(row, c) == 0) {
-                            if (grid.getCandidates(row, c) & pair) {
-                                grid.setCandidates(row, c, grid.getCandidates(row, c) & ~pair);
-                                progress = true;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    // 열
-    for (int col = 0; col < 9; col++) {
-        for (int r1 = 0; r1 < 8; r1++) {
-            if (grid.getValue(r1, col) != 0 || SudokuGrid::countBits(grid.getCandidates(r1, col)) != 2) continue;
-            for (int r2 = r1 + 1; r2 < 9; r2++) {
-                if (grid.getCandidates(r1, col) == grid.getCandidates(r2, col)) {
-                    int pair = grid.getCandidates(r1, col);
-                    for (int r = 0; r < 9; r++) {
-                        if (r != r1 && r != r2 && grid.getValue(r, col) == 0) {
-                            if (grid.getCandidates(r, col) & pair) {
-                                grid.setCandidates(r, col, grid.getCandidates(r, col) & ~pair);
-                                progress = true;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    // 박스
-    for (int br = 0; br < 3; br++) {
-        for (int bc = 0; bc < 3; bc++) {
-            std::vector<std::pair<int, int>> cellsWithTwo;
-            for (int i = 0; i < 3; i++) {
-                for (int j = 0; j < 3; j++) {
-                    int r = br * 3 + i, c = bc * 3 + j;
-                    if (grid.getValue(r, c) == 0 && SudokuGrid::countBits(grid.getCandidates(r, c)) == 2) {
-                        cellsWithTwo.push_back({r, c});
-                    }
-                }
-            }
-            for (size_t i = 0; i < cellsWithTwo.size(); i++) {
-                for (size_t j = i + 1; j < cellsWithTwo.size(); j++) {
-                    int r1 = cellsWithTwo[i].first, c1 = cellsWithTwo[i].second;
-                    int r2 = cellsWithTwo[j].first, c2 = cellsWithTwo[j].second;
-                    if (grid.getCandidates(r1, c1) == grid.getCandidates(r2, c2)) {
-                        int pair = grid.getCandidates(r1, c1);
-                        for (int ii = 0; ii < 3; ii++) {
-                            for (int jj = 0; jj < 3; jj++) {
-                                int r = br * 3 + ii, c = bc * 3 + jj;
-                                if ((r != r1 || c != c1) && (r != r2 || c != c2) && grid.getValue(r, c) == 0) {
-                                    if (grid.getCandidates(r, c) & pair) {
-                                        grid.setCandidates(r, c, grid.getCandidates(r, c) & ~pair);
-                                        progress = true;
-                                    }
-                                }
-                            }
-                        }
+    const Variant& v = grid.getVariant();
+    for (int u = 0; u < v.unitCount(); u++) {
+        const uint8_t* cells = v.unit(u);
+        for (int i = 0; i < 8; i++) {
+            int r1 = cells[i] / 9, c1 = cells[i] % 9;
+            if (grid.getValue(r1, c1) != 0 || SudokuGrid::countBits(grid.getCandidates(r1, c1)) != 2) continue;
+            for (int j = i + 1; j < 9; j++) {
+                int pair = grid.getCandidates(r1, c1);
+                if (grid.getCandidates(cells[j] / 9, cells[j] % 9) != pair) continue;
+                for (int k = 0; k < 9; k++) {
+                    int r = cells[k] / 9, c = cells[k] % 9;
+                    if (k != i && k != j && grid.getValue(r, c) == 0 && (grid.getCandidates(r, c) & pair)) {
+                        eliminate(grid, StrategyId::NakedPair, r, c, grid.getCandidates(r, c) & ~pair);
+                        progress = true;
                     }
                 }
+                if (progress && stepMode) return true;
             }
         }
     }
@@ -146,58 +88,29 @@ bool nakedPairs(SudokuGrid& grid) {
 
 bool nakedTriples(SudokuGrid& grid) {
     bool progress = false;
-    // 행
-    for (int row = 0; row < 9; row++) {
-        std::vector<int> cellsIdx;
-        for (int c = 0; c < 9; c++) {
-            int bits = SudokuGrid::countBits(grid.getCandidates(row, c));
-            if (grid.getValue(row, c) == 0 && bits >= 2 && bits <= 3) {
-                cellsIdx.push_back(c);
-            }
+    const Variant& v = grid.getVariant();
+    for (int u = 0; u < v.unitCount(); u++) {
+        const uint8_t* cells = v.unit(u);
+        int idx[9], n = 0;
+        for (int k = 0; k < 9; k++) {
+            int r = cells[k] / 9, c = cells[k] % 9;
+            int bits = SudokuGrid::countBits(grid.getCandidates(r, c));
+            if (grid.getValue(r, c) == 0 && bits >= 2 && bits <= 3) idx[n++] = k;
         }
-        for (size_t i = 0; i < cellsIdx.size(); i++) {
-            for (size_t j = i + 1; j < cellsIdx.size(); j++) {
-                for (size_t k = j + 1; k < cellsIdx.size(); k++) {
-                    int c1 = cellsIdx[i], c2 = cellsIdx[j], c3 = cellsIdx[k];
-                    int combined = grid.getCandidates(row, c1) | grid.getCandidates(row, c2) | grid.getCandidates(row, c3);
-                    if (SudokuGrid::countBits(combined) == 3) {
-                        for (int c = 0; c < 9; c++) {
-                            if (c != c1 && c != c2 && c != c3 && grid.getValue(row, c) == 0) {
-                                if (grid.getCandidates(row, c) & combined) {
-                                    grid.setCandidates(row, c, grid.getCandidates(row, c) & ~combined);
-                                    progress = true;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    // 열
-    for (int col = 0; col < 9; col++) {
-        std::vector<int> cellsIdx;
-        for (int r = 0; r < 9; r++) {
-            int bits = SudokuGrid::countBits(grid.getCandidates(r, col));
-            if (grid.getValue(r, col) == 0 && bits >= 2 && bits <= 3) {
-                cellsIdx.push_back(r);
-            }
-        }
-        for (size_t i = 0; i < cellsIdx.size(); i++) {
-            for (size_t j = i + 1; j < cellsIdx.size(); j++) {
-                for (size_t k = j + 1; k < cellsIdx.size(); k++) {
-                    int r1 = cellsIdx[i], r2 = cellsIdx[j], r3 = cellsIdx[k];
-                    int combined = grid.getCandidates(r1, col) | grid.getCandidates(r2, col) | grid.getCandidates(r3, col);
-                    if (SudokuGrid::countBits(combined) == 3) {
-                        for (int r = 0; r < 9; r++) {
-                            if (r != r1 && r != r2 && r != r3 && grid.getValue(r, col) == 0) {
-                                if (grid.getCandidates(r, col) & combined) {
-                                    grid.setCandidates(r, col, grid.getCandidates(r, col) & ~combined);
-                                    progress = true;
-                                }
-                            }
+        for (int i = 0; i < n; i++) {
+            for (int j = i + 1; j < n; j++) {
+                for (int l = j + 1; l < n; l++) {
+                    int a = cells[idx[i]], b = cells[idx[j]], d = cells[idx[l]];
+                    int combined = grid.getCandidates(a / 9, a % 9) | grid.getCandidates(b / 9, b % 9) | grid.getCandidates(d / 9, d % 9);
+                    if (SudokuGrid::countBits(combined) != 3) continue;
+                    for (int k = 0; k < 9; k++) {
+                        int r = cells[k] / 9, c = cells[k] % 9;
+                        if (k != idx[i] && k != idx[j] && k != idx[l] && grid.getValue(r, c) == 0 && (grid.getCandidates(r, c) & combined)) {
+                            eliminate(grid, StrategyId::NakedTriple, r, c, grid.getCandidates(r, c) & ~combined);
+                            progress = true;
                         }
                     }
+                    if (progress && stepMode) return true;
                 }
             }
         }
@@ -207,66 +120,38 @@ bool nakedTriples(SudokuGrid& grid) {
 
 bool hiddenPairs(SudokuGrid& grid) {
     bool progress = false;
-    // 행
-    for (int row = 0; row < 9; row++) {
-        for (int n1 = 1; n1 <= 8; n1++) {
-            int bit1 = 1 << (n1 - 1);
-            if (grid.getRowMask(row) & bit1) continue;
-            for (int n2 = n1 + 1; n2 <= 9; n2++) {
-                int bit2 = 1 << (n2 - 1);
-                if (grid.getRowMask(row) & bit2) continue;
-                
-                std::vector<int> positions;
-                for (int c = 0; c < 9; c++) {
-                    if (grid.getValue(row, c) == 0 && ((grid.getCandidates(row, c) & bit1) || (grid.getCandidates(row, c) & bit2))) {
-                        if ((grid.getCandidates(row, c) & bit1) && (grid.getCandidates(row, c) & bit2)) {
-                            positions.push_back(c);
-                        } else {
-                            positions.clear();
-                            break;
-                        }
-                    }
-                }
-                if (positions.size() == 2) {
-                    int pair = bit1 | bit2;
-                    for (int c : positions) {
-                        if (grid.getCandidates(row, c) != pair) {
-                            grid.setCandidates(row, c, pair);
-                            progress = true;
-                        }
-                    }
-                }
-            }
-        }
-    }
-    // 열
-    for (int col = 0; col < 9; col++) {
+    const Variant& v = grid.getVariant();
+    for (int u = 0; u < v.unitCount(); u++) {
+        const uint8_t* cells = v.unit(u);
         for (int n1 = 1; n1 <= 8; n1++) {
             int bit1 = 1 << (n1 - 1);
-            if (grid.getColMask(col) & bit1) continue;
+            if (grid.getUnitMask(u) & bit1) continue;
             for (int n2 = n1 + 1; n2 <= 9; n2++) {
                 int bit2 = 1 << (n2 - 1);
-                if (grid.getColMask(col) & bit2) continue;
+                if (grid.getUnitMask(u) & bit2) continue;
                 
-                std::vector<int> positions;
-                for (int r = 0; r < 9; r++) {
-                    if (grid.getValue(r, col) == 0 && ((grid.getCandidates(r, col) & bit1) || (grid.getCandidates(r, col) & bit2))) {
-                        if ((grid.getCandidates(r, col) & bit1) && (grid.getCandidates(r, col) & bit2)) {
-                            positions.push_back(r);
-                        } else {
-                            positions.clear();
-                            break;
-                        }
+                // 두 숫자가 같은 두 칸에만 있어야 함
+                int positions[9], count = 0;
+                for (int k = 0; k < 9; k++) {
+                    int cand = grid.getCandidates(cells[k] / 9, cells[k] % 9);
+                    if (!(cand & (bit1 | bit2))) continue;
+                    if ((cand & bit1) && (cand & bit2)) {
+                        positions[count++] = cells[k];
+                    } else {
+                        count = 0;
+                        break;
                     }
                 }
-                if (positions.size() == 2) {
+                if (count == 2) {
                     int pair = bit1 | bit2;
-                    for (int r : positions) {
-                        if (grid.getCandidates(r, col) != pair) {
-                            grid.setCandidates(r, col, pair);
+                    for (int k = 0; k < 2; k++) {
+                        int r = positions[k] / 9, c = positions[k] % 9;
+                        if (grid.getCandidates(r, c) != pair) {
+                            eliminate(grid, StrategyId::HiddenPair, r, c, pair);
                             progress = true;
                         }
                     }
+                    if (progress && stepMode) return true;
                 }
             }
         }
@@ -276,73 +161,36 @@ bool hiddenPairs(SudokuGrid& grid) {
 
 bool hiddenTriples(SudokuGrid& grid) {
     bool progress = false;
-    // 행
-    for (int row = 0; row < 9; row++) {
-        for (int n1 = 1; n1 <= 7; n1++) {
-            int bit1 = 1 << (n1 - 1);
-            if (grid.getRowMask(row) & bit1) continue;
-            for (int n2 = n1 + 1; n2 <= 8; n2++) {
-                int bit2 = 1 << (n2 - 1);
-                if (grid.getRowMask(row) & bit2) continue;
-                for (int n3 = n2 + 1; n3 <= 9; n3++) {
-                    int bit3 = 1 << (n3 - 1);
-                    if (grid.getRowMask(row) & bit3) continue;
-                    
-                    int triple = bit1 | bit2 | bit3;
-                    std::vector<int> positions;
-                    bool valid = true;
-                    
-                    for (int c = 0; c < 9 && valid; c++) {
-                        if (grid.getValue(row, c) == 0 && (grid.getCandidates(row, c) & triple)) {
-                            positions.push_back(c);
-                            if (positions.size() > 3) valid = false;
-                        }
-                    }
-                    
-                    if (valid && positions.size() == 3) {
-                        for (int c : positions) {
-                            int newCand = grid.getCandidates(row, c) & triple;
-                            if (grid.getCandidates(row, c) != newCand) {
-                                grid.setCandidates(row, c, newCand);
-                                progress = true;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    // 열
-    for (int col = 0; col < 9; col++) {
+    const Variant& v = grid.getVariant();
+    for (int u = 0; u < v.unitCount(); u++) {
+        const uint8_t* cells = v.unit(u);
+        int used = grid.getUnitMask(u);
         for (int n1 = 1; n1 <= 7; n1++) {
             int bit1 = 1 << (n1 - 1);
-            if (grid.getColMask(col) & bit1) continue;
+            if (used & bit1) continue;
             for (int n2 = n1 + 1; n2 <= 8; n2++) {
                 int bit2 = 1 << (n2 - 1);
-                if (grid.getColMask(col) & bit2) continue;
+                if (used & bit2) continue;
                 for (int n3 = n2 + 1; n3 <= 9; n3++) {
                     int bit3 = 1 << (n3 - 1);
-                    if (grid.getColMask(col) & bit3) continue;
+                    if (used & bit3) continue;
                     
                     int triple = bit1 | bit2 | bit3;
-                    std::vector<int> positions;
-                    bool valid = true;
-                    
-                    for (int r = 0; r < 9 && valid; r++) {
-                        if (grid.getValue(r, col) == 0 && (grid.getCandidates(r, col) & triple)) {
-                            positions.push_back(r);
-                            if (positions.size() > 3) valid = false;
-                        }
+                    int positions[4], count = 0;
+                    for (int k = 0; k < 9 && count <= 3; k++) {
+                        if (grid.getCandidates(cells[k] / 9, cells[k] % 9) & triple) positions[count++] = cells[k];
                     }
                     
-                    if (valid && positions.size() == 3) {
-                        for (int r : positions) {
-                            int newCand = grid.getCandidates(r, col) & triple;
-                            if (grid.getCandidates(r, col) != newCand) {
-                                grid.setCandidates(r, col, newCand);
+                    if (count == 3) {
+                        for (int k = 0; k < 3; k++) {
+                            int r = positions[k] / 9, c = positions[k] % 9;
+                            int newCand = grid.getCandidates(r, c) & triple;
+                            if (grid.getCandidates(r, c) != newCand) {
+                                eliminate(grid, StrategyId::HiddenTriple, r, c, newCand);
                                 progress = true;
                             }
                         }
+                        if (progress && stepMode) return true;
                     }
                 }
             }
@@ -351,180 +199,205 @@ bool hiddenTriples(SudokuGrid& grid) {
     return progress;
 }
 
-bool pointingPairs(SudokuGrid& grid) {
+namespace {
+
+// 유닛 A의 숫자 후보가 모두 다른 유닛 B에도 속하면, B에서 A 밖의 후보를 제거
+bool lockedCandidates(SudokuGrid& grid, int firstUnit, int lastUnit, StrategyId id) {
     bool progress = false;
-    for (int br = 0; br < 3; br++) {
-        for (int bc = 0; bc < 3; bc++) {
-            for (int num = 1; num <= 9; num++) {
-                int bit = 1 << (num - 1);
-                if (grid.getBoxMask(br * 3 + bc) & bit) continue;
-                
-                int rows = 0, cols = 0;
-                for (int i = 0; i < 3; i++) {
-                    for (int j = 0; j < 3; j++) {
-                        if (grid.getCandidates(br * 3 + i, bc * 3 + j) & bit) {
-                            rows |= (1 << i);
-                            cols |= (1 << j);
-                        }
-                    }
-                }
-                if (SudokuGrid::countBits(rows) == 1) {
-                    int ri = 0; while (!(rows & (1 << ri))) ri++;
-                    int row = br * 3 + ri;
-                    for (int c = 0; c < 9; c++) {
-                        if (c / 3 != bc && (grid.getCandidates(row, c) & bit)) {
-                            grid.setCandidates(row, c, grid.getCandidates(row, c) & ~bit);
-                            progress = true;
-                        }
-                    }
-                }
-                if (SudokuGrid::countBits(cols) == 1) {
-                    int ci = 0; while (!(cols & (1 << ci))) ci++;
-                    int col = bc * 3 + ci;
-                    for (int r = 0; r < 9; r++) {
-                        if (r / 3 != br && (grid.getCandidates(r, col) & bit)) {
-                            grid.setCandidates(r, col, grid.getCandidates(r, col) & ~bit);
-                            progress = true;
-                        }
+    const Variant& v = grid.getVariant();
+    for (int a = firstUnit; a < lastUnit; a++) {
+        const uint8_t* cells = v.unit(a);
+        for (int num = 1; num <= 9; num++) {
+            int bit = 1 << (num - 1);
+            if (grid.getUnitMask(a) & bit) continue;
+            
+            int count = 0;
+            uint32_t common = ~0u;
+            for (int k = 0; k < 9; k++) {
+                if (grid.getCandidates(cells[k] / 9, cells[k] % 9) & bit) {
+                    common &= v.unitBits(cells[k]);
+                    count++;
+                }
+            }
+            if (count < 2) continue;
+            common &= ~(1u << a);
+            for (int b = 0; common; b++, common >>= 1) {
+                if (!(common & 1)) continue;
+                const uint8_t* other = v.unit(b);
+                for (int k = 0; k < 9; k++) {
+                    int r = other[k] / 9, c = other[k] % 9;
+                    if (!(v.unitBits(other[k]) & (1u << a)) && (grid.getCandidates(r, c) & bit)) {
+                        eliminate(grid, id, r, c, grid.getCandidates(r, c) & ~bit);
+                        progress = true;
                     }
                 }
+                if (progress && stepMode) return true;
             }
         }
     }
     return progress;
 }
 
-bool boxLineReduction(SudokuGrid& grid) {
+// 한 그룹(상대 유닛 9개)의 교차 구간별 후보 합집합에서 두 구간 이상에 나온 숫자를 빼면
+// 그 구간에만 갇힌 숫자
+inline void confine(const int* unions, int* confined) {
+    int seen = 0, multi = 0;
+    for (int s = 0; s < 9; s++) {
+        multi |= seen & unions[s];
+        seen |= unions[s];
+    }
+    for (int s = 0; s < 9; s++) confined[s] = unions[s] & ~multi;
+}
+
+// 변형 유닛이 없을 때 (기본, 직소, 킬러): 유닛 A를 상대 유닛(영역이면 행과 열, 행/열이면 영역)과의
+// 교차 구간으로 나눠 구간마다 후보를 OR로 모으고, 한 구간에 갇힌 숫자를 상대 유닛 B에서 A 밖의 칸에서 제거.
+// 결과와 제거 순서는 lockedCandidates와 같음
+bool lockedIntersections(SudokuGrid& grid, int firstUnit, int lastUnit, StrategyId id) {
     bool progress = false;
-    // 행
-    for (int row = 0; row < 9; row++) {
-        for (int num = 1; num <= 9; num++) {
-            int bit = 1 << (num - 1);
-            if (grid.getRowMask(row) & bit) continue;
-            
-            int boxFound = -1;
-            bool multiBox = false;
-            for (int c = 0; c < 9 && !multiBox; c++) {
-                if (grid.getCandidates(row, c) & bit) {
-                    int box = c / 3;
-                    if (boxFound == -1) boxFound = box;
-                    else if (boxFound != box) multiBox = true;
-                }
+    const Variant& v = grid.getVariant();
+    for (int a = firstUnit; a < lastUnit; a++) {
+        const uint8_t* cells = v.unit(a);
+        int unions[27] = {};    // 상대 유닛 번호별 (행 0-8, 열 9-17, 영역 18-26)
+        int once = 0, twice = 0;
+        for (int k = 0; k < 9; k++) {
+            int cell = cells[k];
+            int cand = grid.getCandidates(cell / 9, cell % 9);
+            twice |= once & cand;
+            once |= cand;
+            if (a >= 18) {
+                unions[cell / 9] |= cand;
+                unions[9 + cell % 9] |= cand;
+            } else {
+                unions[18 + v.region(cell)] |= cand;
             }
-            
-            if (!multiBox && boxFound != -1) {
-                int br = row / 3, bc = boxFound;
-                for (int i = 0; i < 3; i++) {
-                    int r = br * 3 + i;
-                    if (r != row) {
-                        for (int j = 0; j < 3; j++) {
-                            int c = bc * 3 + j;
-                            if (grid.getCandidates(r, c) & bit) {
-                                grid.setCandidates(r, c, grid.getCandidates(r, c) & ~bit);
-                                progress = true;
-                            }
-                        }
+        }
+        int confined[27] = {};
+        if (a >= 18) {
+            confine(unions, confined);
+            confine(unions + 9, confined + 9);
+        } else {
+            confine(unions + 18, confined + 18);
+        }
+        int locked = 0;
+        for (int b = 0; b < 27; b++) locked |= confined[b];
+        // 후보가 두 칸 이상인 숫자만 (한 칸이면 숨은 싱글)
+        locked &= twice & ~grid.getUnitMask(a);
+
+        for (; locked; locked &= locked - 1) {
+            int bit = locked & -locked;
+            for (int b = 0; b < 27; b++) {
+                if (!(confined[b] & bit)) continue;
+                const uint8_t* other = v.unit(b);
+                for (int k = 0; k < 9; k++) {
+                    int r = other[k] / 9, c = other[k] % 9;
+                    if (!(v.unitBits(other[k]) & (1u << a)) && (grid.getCandidates(r, c) & bit)) {
+                        eliminate(grid, id, r, c, grid.getCandidates(r, c) & ~bit);
+                        progress = true;
                     }
                 }
+                if (progress && stepMode) return true;
             }
         }
     }
-    // 열
-    for (int col = 0; col < 9; col++) {
-        for (int num = 1; num <= 9; num++) {
-            int bit = 1 << (num - 1);
-            if (grid.getColMask(col) & bit) continue;
-            
-            int boxFound = -1;
-            bool multiBox = false;
-            for (int r = 0; r < 9 && !multiBox; r++) {
-                if (grid.getCandidates(r, col) & bit) {
-                    int box = r / 3;
-                    if (boxFound == -1) boxFound = box;
-                    else if (boxFound != box) multiBox = true;
-                }
-            }
-            
-            if (!multiBox && boxFound != -1) {
-                int br = boxFound, bc = col / 3;
-                for (int j = 0; j < 3; j++) {
-                    int c = bc * 3 + j;
-                    if (c != col) {
-                        for (int i = 0; i < 3; i++) {
-                            int r = br * 3 + i;
-                            if (grid.getCandidates(r, c) & bit) {
-                                grid.setCandidates(r, c, grid.getCandidates(r, c) & ~bit);
-                                progress = true;
-                            }
-                        }
-                    }
-                }
+    return progress;
+}
+
+} // namespace
+
+bool pointingPairs(SudokuGrid& grid) {
+    // 영역(과 변형 유닛)의 후보가 한 줄에 몰린 경우
+    int units = grid.getVariant().unitCount();
+    if (units == 27) return lockedIntersections(grid, 18, 27, StrategyId::PointingPair);
+    return lockedCandidates(grid, 18, units, StrategyId::PointingPair);
+}
+
+bool boxLineReduction(SudokuGrid& grid) {
+    // 행/열의 후보가 한 영역에 몰린 경우
+    if (grid.getVariant().unitCount() == 27) return lockedIntersections(grid, 0, 18, StrategyId::BoxLineReduction);
+    return lockedCandidates(grid, 0, 18, StrategyId::BoxLineReduction);
+}
+
+namespace {
+
+// 숫자(bit)가 후보인 위치: 행이면 열 비트, 열이면 행 비트
+inline int rowPositions(const SudokuGrid& grid, int r, int bit) {
+    int mask = 0;
+    for (int c = 0; c < 9; c++) if (grid.getCandidates(r, c) & bit) mask |= 1 << c;
+    return mask;
+}
+
+inline int colPositions(const SudokuGrid& grid, int c, int bit) {
+    int mask = 0;
+    for (int r = 0; r < 9; r++) if (grid.getCandidates(r, c) & bit) mask |= 1 << r;
+    return mask;
+}
+
+// 기준 줄(rows면 행)들이 차지한 위치(cover)의 다른 줄에서 bit 제거
+bool eliminateCover(SudokuGrid& grid, StrategyId id, bool rows, int baseMask, int cover, int bit) {
+    bool progress = false;
+    for (int line = 0; line < 9; line++) {
+        if (baseMask & (1 << line)) continue;
+        for (int pos = 0; pos < 9; pos++) {
+            if (!(cover & (1 << pos))) continue;
+            int r = rows ? line : pos, c = rows ? pos : line;
+            if (grid.getCandidates(r, c) & bit) {
+                eliminate(grid, id, r, c, grid.getCandidates(r, c) & ~bit);
+                progress = true;
             }
         }
     }
     return progress;
 }
 
+} // namespace
+
 bool xWing(SudokuGrid& grid) {
     bool progress = false;
     for (int num = 1; num <= 9; num++) {
         int bit = 1 << (num - 1);
         
-        // 행 기반
-        for (int r1 = 0; r1 < 8; r1++) {
-            std::vector<int> cols1;
-            for (int c = 0; c < 9; c++) {
-                if (grid.getCandidates(r1, c) & bit) cols1.push_back(c);
-            }
-            if (cols1.size() != 2) continue;
-            
-            for (int r2 = r1 + 1; r2 < 9; r2++) {
-                std::vector<int> cols2;
-                for (int c = 0; c < 9; c++) {
-                    if (grid.getCandidates(r2, c) & bit) cols2.push_back(c);
-                }
-                if (cols2.size() == 2 && cols1[0] == cols2[0] && cols1[1] == cols2[1]) {
-                    for (int r = 0; r < 9; r++) {
-                        if (r != r1 && r != r2) {
-                            if (grid.getCandidates(r, cols1[0]) & bit) {
-                                grid.setCandidates(r, cols1[0], grid.getCandidates(r, cols1[0]) & ~bit);
-                                progress = true;
-                            }
-                            if (grid.getCandidates(r, cols1[1]) & bit) {
-                                grid.setCandidates(r, cols1[1], grid.getCandidates(r, cols1[1]) & ~bit);
-                                progress = true;
-                            }
-                        }
-                    }
+        // 행 기반, 열 기반
+        for (int pass = 0; pass < 2; pass++) {
+            bool rows = pass == 0;
+            for (int l1 = 0; l1 < 8; l1++) {
+                int m1 = rows ? rowPositions(grid, l1, bit) : colPositions(grid, l1, bit);
+                if (SudokuGrid::countBits(m1) != 2) continue;
+                
+                for (int l2 = l1 + 1; l2 < 9; l2++) {
+                    int m2 = rows ? rowPositions(grid, l2, bit) : colPositions(grid, l2, bit);
+                    if (m2 != m1) continue;
+                    if (eliminateCover(grid, StrategyId::XWing, rows, (1 << l1) | (1 << l2), m1, bit)) progress = true;
+                    if (progress && stepMode) return true;
                 }
             }
         }
+    }
+    return progress;
+}
+
+bool swordfish(SudokuGrid& grid) {
+    bool progress = false;
+    for (int num = 1; num <= 9; num++) {
+        int bit = 1 << (num - 1);
         
-        // 열 기반
-        for (int c1 = 0; c1 < 8; c1++) {
-            std::vector<int> rows1;
-            for (int r = 0; r < 9; r++) {
-                if (grid.getCandidates(r, c1) & bit) rows1.push_back(r);
+        // 행 기반, 열 기반: 후보가 2-3곳인 줄 셋의 위치 합집합이 3곳이면 Swordfish
+        for (int pass = 0; pass < 2; pass++) {
+            bool rows = pass == 0;
+            int lines[9], masks[9], n = 0;
+            for (int l = 0; l < 9; l++) {
+                int m = rows ? rowPositions(grid, l, bit) : colPositions(grid, l, bit);
+                int cnt = SudokuGrid::countBits(m);
+                if (cnt >= 2 && cnt <= 3) { lines[n] = l; masks[n++] = m; }
             }
-            if (rows1.size() != 2) continue;
             
-            for (int c2 = c1 + 1; c2 < 9; c2++) {
-                std::vector<int> rows2;
-                for (int r = 0; r < 9; r++) {
-                    if (grid.getCandidates(r, c2) & bit) rows2.push_back(r);
-                }
-                if (rows2.size() == 2 && rows1[0] == rows2[0] && rows1[1] == rows2[1]) {
-                    for (int c = 0; c < 9; c++) {
-                        if (c != c1 && c != c2) {
-                            if (grid.getCandidates(rows1[0], c) & bit) {
-                                grid.setCandidates(rows1[0], c, grid.getCandidates(rows1[0], c) & ~bit);
-                                progress = true;
-                            }
-                            if (grid.getCandidates(rows1[1], c) & bit) {
-                                grid.setCandidates(rows1[1], c, grid.getCandidates(rows1[1], c) & ~bit);
-                                progress = true;
-                            }
-                        }
+            for (int i = 0; i < n; i++) {
+                for (int j = i + 1; j < n; j++) {
+                    for (int k = j + 1; k < n; k++) {
+                        int cover = masks[i] | masks[j] | masks[k];
+                        if (SudokuGrid::countBits(cover) != 3) continue;
+                        int base = (1 << lines[i]) | (1 << lines[j]) | (1 << lines[k]);
+                        if (eliminateCover(grid, StrategyId::Swordfish, rows, base, cover, bit)) progress = true;
+                        if (progress && stepMode) return true;
                     }
                 }
             }
@@ -533,176 +406,495 @@ bool xWing(SudokuGrid& grid) {
     return progress;
 }
 
-bool swordfish(SudokuGrid& grid) {
+bool yWing(SudokuGrid& grid) {
     bool progress = false;
-    for (int num = 1; num <= 9; num++) {
-        int bit = 1 << (num - 1);
+    const Variant& v = grid.getVariant();
+    
+    for (int pivotCell = 0; pivotCell < 81; pivotCell++) {
+        int pr = pivotCell / 9, pc = pivotCell % 9;
+        if (grid.getValue(pr, pc) != 0 || SudokuGrid::countBits(grid.getCandidates(pr, pc)) != 2) continue;
         
-        // 행 기반
-        std::vector<std::pair<int, std::vector<int>>> rowData;
-        for (int r = 0; r < 9; r++) {
-            std::vector<int> cols;
-            for (int c = 0; c < 9; c++) {
-                if (grid.getCandidates(r, c) & bit) cols.push_back(c);
-            }
-            if (cols.size() >= 2 && cols.size() <= 3) {
-                rowData.push_back({r, cols});
+        int pivot = grid.getCandidates(pr, pc);
+        int a = 0, b = 0;
+        for (int n = 0; n < 9; n++) {
+            if (pivot & (1 << n)) {
+                if (a == 0) a = n + 1;
+                else b = n + 1;
             }
         }
+        int bitA = 1 << (a - 1), bitB = 1 << (b - 1);
         
-        for (size_t i = 0; i < rowData.size(); i++) {
-            for (size_t j = i + 1; j < rowData.size(); j++) {
-                for (size_t k = j + 1; k < rowData.size(); k++) {
-                    int colMask = 0;
-                    for (int c : rowData[i].second) colMask |= (1 << c);
-                    for (int c : rowData[j].second) colMask |= (1 << c);
-                    for (int c : rowData[k].second) colMask |= (1 << c);
-                    
-                    if (SudokuGrid::countBits(colMask) == 3) {
-                        std::vector<int> sfCols;
-                        for (int c = 0; c < 9; c++) {
-                            if (colMask & (1 << c)) sfCols.push_back(c);
-                        }
-                        int r1 = rowData[i].first, r2 = rowData[j].first, r3 = rowData[k].first;
-                        for (int r = 0; r < 9; r++) {
-                            if (r != r1 && r != r2 && r != r3) {
-                                for (int c : sfCols) {
-                                    if (grid.getCandidates(r, c) & bit) {
-                                        grid.setCandidates(r, c, grid.getCandidates(r, c) & ~bit);
-                                        progress = true;
-                                    }
-                                }
-                            }
+        // 피벗이 보는 두 후보 칸
+        int wings[Variant::MAX_PEERS], wingCount = 0;
+        const uint8_t* peers = v.peers(pivotCell);
+        for (int k = 0; k < v.peerCount(pivotCell); k++) {
+            int r = peers[k] / 9, c = peers[k] % 9;
+            if (grid.getValue(r, c) == 0 && SudokuGrid::countBits(grid.getCandidates(r, c)) == 2) wings[wingCount++] = peers[k];
+        }
+        
+        for (int i = 0; i < wingCount; i++) {
+            int cand1 = grid.getCandidates(wings[i] / 9, wings[i] % 9);
+            if (!((cand1 & bitA) && !(cand1 & bitB))) continue;
+            int candC1 = cand1 & ~bitA;
+            
+            for (int j = 0; j < wingCount; j++) {
+                if (i == j) continue;
+                int cand2 = grid.getCandidates(wings[j] / 9, wings[j] % 9);
+                if (!((cand2 & bitB) && !(cand2 & bitA))) continue;
+                int candC2 = cand2 & ~bitB;
+                
+                if (candC1 == candC2 && SudokuGrid::countBits(candC1) == 1) {
+                    int bitC = candC1;
+                    // 두 날개가 모두 보는 칸
+                    const uint8_t* seen = v.peers(wings[i]);
+                    for (int k = 0; k < v.peerCount(wings[i]); k++) {
+                        int cell = seen[k], r = cell / 9, c = cell % 9;
+                        if (cell != wings[j] && v.sees(cell, wings[j]) && grid.getValue(r, c) == 0 && (grid.getCandidates(r, c) & bitC)) {
+                            eliminate(grid, StrategyId::YWing, r, c, grid.getCandidates(r, c) & ~bitC);
+                            progress = true;
                         }
                     }
+                    if (progress && stepMode) return true;
                 }
             }
         }
-        
-        // 열 기반
-        std::vector<std::pair<int, std::vector<int>>> colData;
-        for (int c = 0; c < 9; c++) {
-            std::vector<int> rows;
-            for (int r = 0; r < 9; r++) {
-                if (grid.getCandidates(r, c) & bit) rows.push_back(r);
-            }
-            if (rows.size() >= 2 && rows.size() <= 3) {
-                colData.push_back({c, rows});
+    }
+    return progress;
+}
+
+namespace {
+
+// 가정한 상태에서 싱글만 전파 (기록하지 않음). 모순이면 false
+bool propagateSingles(SudokuGrid& grid) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int i = 0; i < 9; i++) {
+            for (int j = 0; j < 9; j++) {
+                if (grid.getValue(i, j) != 0) continue;
+                int cand = grid.getCandidates(i, j);
+                if (cand == 0) return false;
+                if ((cand & (cand - 1)) == 0) {
+                    int num = 1;
+                    while (!(cand & 1)) { cand >>= 1; num++; }
+                    grid.setCell(i, j, num);
+                    changed = true;
+                }
             }
         }
-        
-        for (size_t i = 0; i < colData.size(); i++) {
-            for (size_t j = i + 1; j < colData.size(); j++) {
-                for (size_t k = j + 1; k < colData.size(); k++) {
-                    int rowMaskSF = 0;
-                    for (int r : colData[i].second) rowMaskSF |= (1 << r);
-                    for (int r : colData[j].second) rowMaskSF |= (1 << r);
-                    for (int r : colData[k].second) rowMaskSF |= (1 << r);
-                    
-                    if (SudokuGrid::countBits(rowMaskSF) == 3) {
-                        std::vector<int> sfRows;
-                        for (int r = 0; r < 9; r++) {
-                            if (rowMaskSF & (1 << r)) sfRows.push_back(r);
-                        }
-                        int c1 = colData[i].first, c2 = colData[j].first, c3 = colData[k].first;
-                        for (int c = 0; c < 9; c++) {
-                            if (c != c1 && c != c2 && c != c3) {
-                                for (int r : sfRows) {
-                                    if (grid.getCandidates(r, c) & bit) {
-                                        grid.setCandidates(r, c, grid.getCandidates(r, c) & ~bit);
-                                        progress = true;
-                                    }
-                                }
-                            }
-                        }
-                    }
+        const Variant& v = grid.getVariant();
+        for (int unit = 0; unit < v.unitCount(); unit++) {
+            for (int num = 1; num <= 9; num++) {
+                int bit = 1 << (num - 1);
+                int cnt = 0, pr = -1, pc = -1;
+                bool placed = false;
+                for (int k = 0; k < 9 && cnt <= 1; k++) {
+                    int r = v.unit(unit)[k] / 9, c = v.unit(unit)[k] % 9;
+                    if (grid.getValue(r, c) == num) { placed = true; break; }
+                    if (grid.getCandidates(r, c) & bit) { pr = r; pc = c; cnt++; }
                 }
+                if (placed) continue;
+                if (cnt == 0) return false;
+                if (cnt == 1) { grid.setCell(pr, pc, num); changed = true; }
             }
         }
     }
-    return progress;
+    return true;
 }
 
-bool yWing(SudokuGrid& grid) {
+// 가정 뒤 칸이 가질 수 있는 값 (확정됐으면 그 값 하나)
+inline int possible(const SudokuGrid& grid, int row, int col) {
+    int val = grid.getValue(row, col);
+    return val ? 1 << (val - 1) : grid.getCandidates(row, col);
+}
+
+} // namespace
+
+bool forcingChains(SudokuGrid& grid) {
     bool progress = false;
-    
-    struct WingCell { int row, col, cand; };
-    
     for (int pr = 0; pr < 9; pr++) {
         for (int pc = 0; pc < 9; pc++) {
             if (grid.getValue(pr, pc) != 0 || SudokuGrid::countBits(grid.getCandidates(pr, pc)) != 2) continue;
-            
-            int pivot = grid.getCandidates(pr, pc);
-            int a = 0, b = 0;
-            for (int n = 0; n < 9; n++) {
-                if (pivot & (1 << n)) {
-                    if (a == 0) a = n + 1;
-                    else b = n + 1;
-                }
-            }
-            int bitA = 1 << (a - 1), bitB = 1 << (b - 1);
-            
-            std::vector<WingCell> wings;
-            
-            for (int c = 0; c < 9; c++) {
-                if (c != pc && grid.getValue(pr, c) == 0 && SudokuGrid::countBits(grid.getCandidates(pr, c)) == 2) {
-                    wings.push_back({pr, c, grid.getCandidates(pr, c)});
-                }
+
+            int cand = grid.getCandidates(pr, pc);
+            int a = 1;
+            while (!(cand & (1 << (a - 1)))) a++;
+            int b = a + 1;
+            while (!(cand & (1 << (b - 1)))) b++;
+
+            // 두 갈래를 각각 복사본에서 전파
+            SudokuGrid branchA = grid, branchB = grid;
+            branchA.setCell(pr, pc, a);
+            branchB.setCell(pr, pc, b);
+            bool okA = propagateSingles(branchA);
+            bool okB = propagateSingles(branchB);
+
+            if (!okA && !okB) return progress;  // 퍼즐 자체가 모순
+            if (!okA || !okB) {
+                place(grid, StrategyId::ForcingChain, pr, pc, okA ? a : b);
+                progress = true;
+                if (stepMode) return true;
+                continue;
             }
+
+            // 두 갈래 모두에서 성립하는 확정/제거
             for (int r = 0; r < 9; r++) {
-                if (r != pr && grid.getValue(r, pc) == 0 && SudokuGrid::countBits(grid.getCandidates(r, pc)) == 2) {
-                    wings.push_back({r, pc, grid.getCandidates(r, pc)});
+                for (int c = 0; c < 9; c++) {
+                    if (grid.getValue(r, c) != 0) continue;
+                    int both = possible(branchA, r, c) | possible(branchB, r, c);
+                    int current = grid.getCandidates(r, c);
+                    if ((both & (both - 1)) == 0 && (current & both) && current != both) {
+                        int num = 1;
+                        while (!(both & (1 << (num - 1)))) num++;
+                        if (!grid.isValidMove(r, c, num)) continue;
+                        place(grid, StrategyId::ForcingChain, r, c, num);
+                        progress = true;
+                    } else if (current & ~both) {
+                        eliminate(grid, StrategyId::ForcingChain, r, c, current & both);
+                        progress = true;
+                    }
                 }
             }
-            int br = (pr / 3) * 3, bc = (pc / 3) * 3;
-            for (int i = 0; i < 3; i++) {
-                for (int j = 0; j < 3; j++) {
-                    int r = br + i, c = bc + j;
-                    if ((r != pr || c != pc) && r != pr && c != pc && 
-                        grid.getValue(r, c) == 0 && SudokuGrid::countBits(grid.getCandidates(r, c)) == 2) {
-                        wings.push_back({r, c, grid.getCandidates(r, c)});
-                    }
+            if (progress && stepMode) return true;
+        }
+    }
+    return progress;
+}
+
+namespace {
+
+// 케이지의 빈 칸과 그 후보, 그리고 빈 칸에 올 수 있는 숫자: 놓인 숫자와 겹치지 않고, 후보 안에 있으며,
+// 빈 칸마다 하나는 들어갈 수 있는 (칸 수, 남은 합) 조합들의 합집합. 그런 조합이 없으면 -1
+struct CageState {
+    int empty = 0;
+    int cells[9];
+    int cands[9];
+};
+
+int cageAllowed(const SudokuGrid& grid, const Variant::Cage& cage, CageState& st) {
+    int placed = 0, sum = 0, any = 0;
+    for (int m = 0; m < cage.size; m++) {
+        int r = cage.cells[m] / 9, c = cage.cells[m] % 9;
+        int val = grid.getValue(r, c);
+        if (val) { placed |= 1 << (val - 1); sum += val; continue; }
+        st.cells[st.empty] = cage.cells[m];
+        st.cands[st.empty] = grid.getCandidates(r, c);
+        any |= st.cands[st.empty++];
+    }
+    int count;
+    const uint16_t* combos = Variant::combos(st.empty, cage.sum - sum, count);
+    int allowed = -1;
+    for (int n = 0; n < count; n++) {
+        int combo = combos[n];
+        if ((combo & placed) || (combo & ~any)) continue;
+        bool fits = true;
+        for (int m = 0; m < st.empty && fits; m++) fits = (st.cands[m] & combo) != 0;
+        if (fits) allowed = (allowed < 0 ? 0 : allowed) | combo;
+    }
+    return allowed;
+}
+
+// 탐색용: cell에 숫자를 놓은 뒤 모든 케이지의 빈 칸 후보를 더 줄지 않을 때까지 줄임 (기록하지 않음).
+// 합을 맞출 수 없는 케이지가 생기면 false
+bool restrictCages(SudokuGrid& grid, int cell) {
+    const Variant& v = grid.getVariant();
+    if (v.cageOf(cell) < 0) return true;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int k = 0; k < v.cageCount(); k++) {
+            CageState st;
+            int allowed = cageAllowed(grid, v.cage(k), st);
+            if (allowed < 0) return false;
+            for (int m = 0; m < st.empty; m++) {
+                if (st.cands[m] & ~allowed) {
+                    grid.setCandidates(st.cells[m] / 9, st.cells[m] % 9, st.cands[m] & allowed);
+                    changed = true;
                 }
             }
-            
-            for (size_t i = 0; i < wings.size(); i++) {
-                int r1 = wings[i].row, c1 = wings[i].col, cand1 = wings[i].cand;
-                if (!((cand1 & bitA) && !(cand1 & bitB))) continue;
-                int candC1 = cand1 & ~bitA;
-                
-                for (size_t j = 0; j < wings.size(); j++) {
-                    if (i == j) continue;
-                    int r2 = wings[j].row, c2 = wings[j].col, cand2 = wings[j].cand;
-                    if (!((cand2 & bitB) && !(cand2 & bitA))) continue;
-                    int candC2 = cand2 & ~bitB;
-                    
-                    if (candC1 == candC2 && SudokuGrid::countBits(candC1) == 1) {
-                        int bitC = candC1;
-                        for (int r = 0; r < 9; r++) {
-                            for (int c = 0; c < 9; c++) {
-                                if (grid.getValue(r, c) != 0) continue;
-                                bool sees1 = (r == r1 || c == c1 || (r / 3 == r1 / 3 && c / 3 == c1 / 3));
-                                bool sees2 = (r == r2 || c == c2 || (r / 3 == r2 / 3 && c / 3 == c2 / 3));
-                                if (sees1 && sees2 && (r != r1 || c != c1) && (r != r2 || c != c2)) {
-                                    if (grid.getCandidates(r, c) & bitC) {
-                                        grid.setCandidates(r, c, grid.getCandidates(r, c) & ~bitC);
-                                        progress = true;
-                                    }
-                                }
-                            }
-                        }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool killerCages(SudokuGrid& grid) {
+    bool progress = false;
+    const Variant& v = grid.getVariant();
+    for (int k = 0; k < v.cageCount(); k++) {
+        CageState st;
+        int allowed = cageAllowed(grid, v.cage(k), st);
+        if (allowed < 0) continue;     // 모순은 다른 단계에서 드러남
+
+        bool changed = false;
+        for (int m = 0; m < st.empty; m++) {
+            if (st.cands[m] & ~allowed) {
+                eliminate(grid, StrategyId::KillerCage, st.cells[m] / 9, st.cells[m] % 9, st.cands[m] & allowed);
+                changed = true;
+            }
+        }
+        if (changed) {
+            progress = true;
+            if (stepMode) return true;
+        }
+    }
+    return progress;
+}
+
+namespace {
+
+// 충돌 지향 탐색: 막다른 칸의 원인이 된 결정들만 모아 그 결정으로 바로 되돌아가고 (backjump),
+// 함께 성립할 수 없는 결정 집합(nogood)을 배워 같은 막다른 가지를 다시 내려가지 않음
+thread_local bool hasSearchDeadline = false;
+thread_local std::chrono::steady_clock::time_point searchDeadline;
+
+const int NOGOOD_MAX_SIZE = 12;         // 더 긴 nogood는 다시 맞을 일이 드물어 저장하지 않음
+const size_t NOGOOD_CAPACITY = 4096;    // 넘치면 적게 쓰인 절반을 버림
+
+typedef std::bitset<81> LevelSet;
+
+struct Nogood {
+    uint8_t size;
+    uint8_t cells[NOGOOD_MAX_SIZE];
+    uint8_t digits[NOGOOD_MAX_SIZE];
+    uint32_t hits;
+};
+
+// nogood 저장소와 감시 목록은 arena에서 잡음. 감시 목록은 리터럴(id * NOGOOD_MAX_SIZE + k)을 잇는
+// 연결 리스트라 (칸, 숫자)마다 따로 할당하지 않음
+const uint16_t NO_LITERAL = 0xFFFF;
+const int WATCH_COUNT = 81 * 9;
+
+static_assert(NOGOOD_CAPACITY * NOGOOD_MAX_SIZE < NO_LITERAL, "리터럴 번호는 uint16_t");
+static_assert(NOGOOD_CAPACITY * (sizeof(Nogood) + NOGOOD_MAX_SIZE * sizeof(uint16_t))
+    + 2 * WATCH_COUNT * sizeof(uint16_t) + 64 <= SEARCH_SCRATCH_BYTES, "SEARCH_SCRATCH_BYTES가 모자람");
+
+class Search {
+public:
+    // scratch가 모자라면 false
+    bool attach(Arena& scratch) {
+        nogoods = scratch.alloc<Nogood>(NOGOOD_CAPACITY);
+        next = scratch.alloc<uint16_t>(NOGOOD_CAPACITY * NOGOOD_MAX_SIZE);
+        head = scratch.alloc<uint16_t>(WATCH_COUNT);
+        tail = scratch.alloc<uint16_t>(WATCH_COUNT);
+        return nogoods && next && head && tail;
+    }
+
+    bool run(SudokuGrid& grid, SearchStats& stats) {
+        root = grid;
+        levelOf.fill(-1);
+        count = 0;
+        std::fill(head, head + WATCH_COUNT, NO_LITERAL);
+        this->stats = &stats;
+        LevelSet conflict;
+        return descend(grid, 0, conflict) && !stats.expired;
+    }
+
+private:
+    bool descend(SudokuGrid& grid, int depth, LevelSet& conflict) {
+        int minCand = 10, bestRow = -1, bestCol = -1;
+        for (int i = 0; i < 9 && minCand > 0; i++) {
+            for (int j = 0; j < 9; j++) {
+                if (grid.getValue(i, j) == 0) {
+                    int count = SudokuGrid::countBits(grid.getCandidates(i, j));
+                    if (count < minCand) {
+                        minCand = count;
+                        bestRow = i;
+                        bestCol = j;
+                        if (count == 0) break;
                     }
                 }
             }
         }
+        if (bestRow == -1) return true;
+
+        int cell = bestRow * 9 + bestCol;
+        int cand = grid.getCandidates(bestRow, bestCol);
+        LevelSet mine;
+
+        for (int num = 1; num <= 9; num++) {
+            if (!(cand & (1 << (num - 1)))) continue;
+            // 시계는 비싸므로 노드 256개마다 확인하고, 넘겼으면 배우지 않고 곧장 빠져나감
+            if ((++stats->nodes & 255) == 0 && hasSearchDeadline && std::chrono::steady_clock::now() >= searchDeadline) {
+                stats->expired = true;
+            }
+            if (stats->expired) return false;
+            levelOf[cell] = depth;
+            cellAt[depth] = cell;
+            digitAt[depth] = num;
+
+            LevelSet sub;
+            if (violates(cell, num, sub)) {
+                stats->nogoodHits++;
+            } else {
+                SudokuGrid next = grid;
+                next.setCell(bestRow, bestCol, num);
+                if (!restrictCages(next, cell)) {
+                    allLevels(depth + 1, sub);
+                } else if (descend(next, depth + 1, sub)) {
+                    grid = next;
+                    return true;
+                } else if (stats->expired) {
+                    return false;
+                }
+            }
+            levelOf[cell] = -1;
+
+            // 이 칸의 값과 무관한 실패면 나머지 값도 실패하므로 원인 결정까지 바로 되돌아감
+            if (!sub.test(depth)) {
+                stats->backjumps++;
+                conflict = sub;
+                return false;
+            }
+            sub.reset(depth);
+            mine |= sub;
+        }
+        // 원래 후보 중 사라진 것은 이웃의 결정 때문
+        explain(grid, bestRow, bestCol, root.getCandidates(bestRow, bestCol) & ~cand, depth, mine);
+        learn(mine, depth);
+        conflict = mine;
+        return false;
     }
-    return progress;
+
+    // removed의 각 숫자를 놓은 가장 이른 이웃 결정을 conflict에 추가.
+    // 그런 이웃이 없으면 케이지 조합 때문에 지워진 것인데, 조합은 케이지 칸들의 후보에 따라 달라지므로
+    // 원인을 좁히지 않고 지금까지의 결정 전부로 봄
+    void explain(const SudokuGrid& grid, int row, int col, int removed, int depth, LevelSet& conflict) const {
+        const Variant& v = grid.getVariant();
+        const uint8_t* peers = v.peers(row * 9 + col);
+        for (int num = 1; num <= 9; num++) {
+            if (!(removed & (1 << (num - 1)))) continue;
+            int best = 81;
+            for (int k = 0; k < v.peerCount(row * 9 + col); k++) {
+                int level = levelOf[peers[k]];
+                if (level >= 0 && level < best && grid.getValue(peers[k] / 9, peers[k] % 9) == num) best = level;
+            }
+            if (best < 81) conflict.set(best);
+            else allLevels(depth, conflict);
+        }
+    }
+
+    static void allLevels(int depth, LevelSet& conflict) {
+        for (int level = 0; level < depth; level++) conflict.set(level);
+    }
+
+    // cell = num을 놓으면 배운 nogood가 모두 성립하는지
+    bool violates(int cell, int num, LevelSet& conflict) {
+        for (uint16_t lit = head[cell * 9 + num - 1]; lit != NO_LITERAL; lit = next[lit]) {
+            Nogood& ng = nogoods[lit / NOGOOD_MAX_SIZE];
+            bool holds = true;
+            for (int k = 0; k < ng.size && holds; k++) {
+                int level = levelOf[ng.cells[k]];
+                holds = level >= 0 && digitAt[level] == ng.digits[k];
+            }
+            if (!holds) continue;
+            ng.hits++;
+            for (int k = 0; k < ng.size; k++) conflict.set(levelOf[ng.cells[k]]);
+            return true;
+        }
+        return false;
+    }
+
+    void learn(const LevelSet& levels, int depth) {
+        if (levels.none() || (int)levels.count() > NOGOOD_MAX_SIZE) return;
+        if (count >= NOGOOD_CAPACITY) prune();
+        Nogood ng;
+        ng.size = 0;
+        ng.hits = 0;
+        for (int level = 0; level < depth; level++) {
+            if (!levels.test(level)) continue;
+            ng.cells[ng.size] = (uint8_t)cellAt[level];
+            ng.digits[ng.size] = (uint8_t)digitAt[level];
+            ng.size++;
+        }
+        add(ng);
+        stats->learned++;
+    }
+
+    void add(const Nogood& ng) {
+        size_t id = count++;
+        nogoods[id] = ng;
+        link(id);
+    }
+
+    // 감시 목록 끝에 붙임 (먼저 배운 nogood부터 검사)
+    void link(size_t id) {
+        const Nogood& ng = nogoods[id];
+        for (int k = 0; k < ng.size; k++) {
+            uint16_t lit = (uint16_t)(id * NOGOOD_MAX_SIZE + k);
+            int w = ng.cells[k] * 9 + ng.digits[k] - 1;
+            next[lit] = NO_LITERAL;
+            if (head[w] == NO_LITERAL) head[w] = lit;
+            else next[tail[w]] = lit;
+            tail[w] = lit;
+        }
+    }
+
+    // 많이 쓰인 것, 짧은 것 순으로 절반만 남김 (제자리 정렬)
+    void prune() {
+        std::sort(nogoods, nogoods + count, [](const Nogood& x, const Nogood& y) {
+            return x.hits != y.hits ? x.hits > y.hits : x.size < y.size;
+        });
+        count = NOGOOD_CAPACITY / 2;
+        std::fill(head, head + WATCH_COUNT, NO_LITERAL);
+        for (size_t id = 0; id < count; id++) {
+            nogoods[id].hits /= 2;
+            link(id);
+        }
+        stats->pruned++;
+    }
+
+    SudokuGrid root;
+    std::array<int, 81> levelOf;
+    std::array<int, 81> cellAt;
+    std::array<int, 81> digitAt;
+    Nogood* nogoods = nullptr;
+    size_t count = 0;
+    uint16_t* next = nullptr;       // 같은 (칸, 숫자)를 감시하는 다음 리터럴
+    uint16_t* head = nullptr;       // (칸, 숫자)마다 그 결정을 포함한 nogood 리터럴 목록
+    uint16_t* tail = nullptr;
+    SearchStats* stats = nullptr;
+};
+
+thread_local SearchStats lastStats;
+
+} // namespace
+
+void setSearchDeadline(std::chrono::steady_clock::time_point deadline) {
+    hasSearchDeadline = true;
+    searchDeadline = deadline;
 }
 
+void clearSearchDeadline() { hasSearchDeadline = false; }
+
 bool backtrack(SudokuGrid& grid) {
-    // 가장 후보가 적은 빈 셀 찾기
+    // 컨텍스트 없이 부르면 스레드마다 하나 둔 스크래치를 씀
+    thread_local Arena scratch(SEARCH_SCRATCH_BYTES);
+    return backtrack(grid, scratch);
+}
+
+bool backtrack(SudokuGrid& grid, Arena& scratch) {
+    size_t mark = scratch.mark();
+    Search search;
+    if (!search.attach(scratch)) {
+        scratch.rewind(mark);
+        return backtrack(grid);
+    }
+    lastStats = SearchStats();
+    bool solved = search.run(grid, lastStats);
+    scratch.rewind(mark);
+    return solved;
+}
+
+SearchStats getSearchStats() { return lastStats; }
+
+namespace {
+
+// 후보가 가장 적은 빈칸 (빈칸이 없으면 -1)
+int fewestCandidates(const SudokuGrid& grid) {
     int minCand = 10, bestRow = -1, bestCol = -1;
-    for (int i = 0; i < 9; i++) {
+    for (int i = 0; i < 9 && minCand > 1; i++) {
         for (int j = 0; j < 9; j++) {
             if (grid.getValue(i, j) == 0) {
                 int count = SudokuGrid::countBits(grid.getCandidates(i, j));
@@ -710,44 +902,73 @@ bool backtrack(SudokuGrid& grid) {
                     minCand = count;
                     bestRow = i;
                     bestCol = j;
+                    if (count <= 1) break;
                 }
             }
         }
     }
+    return bestRow == -1 ? -1 : bestRow * 9 + bestCol;
+}
+
+} // namespace
+
+int countSolutions(const SudokuGrid& grid, int limit) {
+    int cell = fewestCandidates(grid);
+    if (cell == -1) return 1;
     
-    if (bestRow == -1) return true;
-    
+    int bestRow = cell / 9, bestCol = cell % 9;
     int cand = grid.getCandidates(bestRow, bestCol);
-    if (cand == 0) return false;
-    
-    // 현재 상태 저장
-    std::array<std::array<int, 9>, 9> savedGrid;
-    std::array<std::array<int, 9>, 9> savedCandidates;
-    
-    for (int i = 0; i < 9; i++) {
-        for (int j = 0; j < 9; j++) {
-            savedGrid[i][j] = grid.getValue(i, j);
-            savedCandidates[i][j] = grid.getCandidates(i, j);
+    int found = 0;
+    for (int num = 1; num <= 9 && found < limit; num++) {
+        if (cand & (1 << (num - 1))) {
+            SudokuGrid next = grid;
+            next.setCell(bestRow, bestCol, num);
+            if (restrictCages(next, cell)) found += countSolutions(next, limit - found);
         }
     }
-    
+    return found;
+}
+
+bool enumerateSolutions(const SudokuGrid& grid, const std::function<bool(const SudokuGrid&)>& visit) {
+    int cell = fewestCandidates(grid);
+    if (cell == -1) return visit(grid);
+
+    int row = cell / 9, col = cell % 9;
+    int cand = grid.getCandidates(row, col);
     for (int num = 1; num <= 9; num++) {
-        if (cand & (1 << (num - 1))) {
-            grid.setCell(bestRow, bestCol, num);
-            if (backtrack(grid)) return true;
-            
-            // 상태 복원
-            for (int i = 0; i < 9; i++) {
-                for (int j = 0; j < 9; j++) {
-                    if (savedGrid[i][j] == 0 && grid.getValue(i, j) != 0) {
-                        grid.clearCell(i, j, grid.getValue(i, j));
-                    }
-                    grid.setCandidates(i, j, savedCandidates[i][j]);
-                }
+        if (!(cand & (1 << (num - 1)))) continue;
+        SudokuGrid next = grid;
+        next.setCell(row, col, num);
+        if (restrictCages(next, cell) && !enumerateSolutions(next, visit)) return false;
+    }
+    return true;
+}
+
+void splitSearch(const SudokuGrid& grid, size_t count, std::vector<SudokuGrid>& out) {
+    out.assign(1, grid);
+    std::vector<SudokuGrid> next;
+    while (out.size() < count) {
+        // 한 단계씩 모두 펼쳐야 가지 순서가 탐색 순서와 같음
+        next.clear();
+        bool expanded = false;
+        for (const SudokuGrid& g : out) {
+            int cell = fewestCandidates(g);
+            if (cell == -1) {
+                next.push_back(g);
+                continue;
+            }
+            expanded = true;
+            int cand = g.getCandidates(cell / 9, cell % 9);
+            for (int num = 1; num <= 9; num++) {
+                if (!(cand & (1 << (num - 1)))) continue;
+                next.push_back(g);
+                next.back().setCell(cell / 9, cell % 9, num);
+                if (!restrictCages(next.back(), cell)) next.pop_back();
             }
         }
+        out.swap(next);
+        if (!expanded) break;
     }
-    return false;
 }
 
-} // namespace Strategies
\ No newline at end of file
+} // namespace Strategies
@@ -1,7 +1,35 @@
 #pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "arena.h"
 #include "sudoku_grid.h"
 
 namespace Strategies {
+    enum class StrategyId : uint8_t {
+        NakedSingle,
+        HiddenSingle,
+        NakedPair,
+        NakedTriple,
+        HiddenPair,
+        HiddenTriple,
+        PointingPair,
+        BoxLineReduction,
+        XWing,
+        Swordfish,
+        YWing,
+        ForcingChain,
+        KillerCage,
+        Backtrack,
+        Count
+    };
+    
+    // true면 각 전략이 패턴 하나를 적용하자마자 반환 (스레드별 설정)
+    void setStepMode(bool enabled);
+    bool getStepMode();
+    
     // 기본 전략
     bool nakedSingles(SudokuGrid& grid);
     bool hiddenSingles(SudokuGrid& grid);
@@ -18,7 +46,37 @@ namespace Strategies {
     bool xWing(SudokuGrid& grid);
     bool swordfish(SudokuGrid& grid);
     bool yWing(SudokuGrid& grid);
+    // 두 후보 칸의 각 값을 가정해 싱글만 전파, 양쪽에 공통인 결과나 모순에서 나온 결과를 적용
+    bool forcingChains(SudokuGrid& grid);
+    
+    // 킬러 퍼즐: (칸 수, 합) 조합 표를 후보와 맞춰 보고 어느 조합에도 없는 후보를 지움
+    bool killerCages(SudokuGrid& grid);
     
-    // 백트래킹
+    // 백트래킹 (충돌 원인으로 되돌아가며 nogood를 배움)
+    struct SearchStats {
+        uint64_t nodes = 0;         // 시도한 값
+        uint64_t backjumps = 0;     // 원인 결정까지 건너뛴 횟수
+        uint64_t learned = 0;       // 저장한 nogood
+        uint64_t nogoodHits = 0;    // nogood로 잘라낸 가지
+        uint64_t pruned = 0;        // 저장소 정리 횟수
+        bool expired = false;       // 시한을 넘겨 중단함
+    };
+    // 이 스레드의 backtrack()이 멈출 시각 (노드 256개마다 확인, 스레드별 설정).
+    // 넘기면 grid를 그대로 두고 false를 돌려주며 SearchStats::expired가 켜짐
+    void setSearchDeadline(std::chrono::steady_clock::time_point deadline);
+    void clearSearchDeadline();
+    // 탐색 메모리(nogood 저장소, 감시 목록)는 scratch에서 잡고 끝나면 되돌림. 모자라면 스레드별 기본 스크래치를 씀
+    const size_t SEARCH_SCRATCH_BYTES = 256 << 10;
     bool backtrack(SudokuGrid& grid);
+    bool backtrack(SudokuGrid& grid, Arena& scratch);
+    // 이 스레드에서 마지막 backtrack() 호출의 통계
+    SearchStats getSearchStats();
+    // 해의 개수를 limit까지 셈 (grid는 후보가 갱신된 상태)
+    int countSolutions(const SudokuGrid& grid, int limit);
+    // 모든 해를 차례로 visit에 넘김 (칸은 후보가 적은 순, 숫자는 오름차순).
+    // visit가 false를 돌려주면 그 자리에서 멈추고 false
+    bool enumerateSolutions(const SudokuGrid& grid, const std::function<bool(const SudokuGrid&)>& visit);
+    // 탐색 나무의 위쪽을 단계별로 펼쳐 적어도 count개의 가지로 나눔 (병렬 탐색용, 가지 순서는 탐색 순서와 같음).
+    // 막힌 가지는 버리고, 더 펼칠 수 없으면 count보다 적을 수 있음
+    void splitSearch(const SudokuGrid& grid, size_t count, std::vector<SudokuGrid>& out);
 }
@@ -0,0 +1,107 @@
+#include "sudoku_api.h"
+#include "arena.h"
+#include "corpus_reader.h"
+#include "solver.h"
+#include "strategies.h"
+#include "variant.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+// 전략 비트는 StrategyId 순서와 같음
+using Id = Strategies::StrategyId;
+static_assert(SUDOKU_STRATEGY_NAKED_SINGLE == 1u << (int)Id::NakedSingle, "SUDOKU_STRATEGY_* != StrategyId");
+static_assert(SUDOKU_STRATEGY_BOX_LINE_REDUCTION == 1u << (int)Id::BoxLineReduction, "SUDOKU_STRATEGY_* != StrategyId");
+static_assert(SUDOKU_STRATEGY_FORCING_CHAIN == 1u << (int)Id::ForcingChain, "SUDOKU_STRATEGY_* != StrategyId");
+
+// 스레드마다 처음 부를 때 한 번 만들고 계속 씀
+struct ThreadState {
+    SudokuSolver solver;
+    Arena scratch;
+    ThreadState() : scratch(Strategies::SEARCH_SCRATCH_BYTES) { solver.setScratch(&scratch); }
+};
+
+ThreadState& threadState() {
+    static thread_local ThreadState state;
+    return state;
+}
+
+void formatGrid(const SudokuGrid& grid, char* out) {
+    for (int i = 0; i < 81; i++) {
+        int val = grid.getValue(i / 9, i % 9);
+        out[i] = val ? (char)('0' + val) : '.';
+    }
+}
+
+} // namespace
+
+extern "C" {
+
+int sudoku_api_version(void) {
+    return SUDOKU_API_VERSION;
+}
+
+void sudoku_options_init(sudoku_options* options) {
+    memset(options, 0, sizeof(*options));
+    options->size = sizeof(*options);
+    options->engine = SUDOKU_ENGINE_HYBRID;
+    options->strategies = SUDOKU_STRATEGY_ALL;
+    options->variant = SUDOKU_VARIANT_CLASSIC;
+}
+
+size_t sudoku_solve_batch(const char* in, char* out, size_t n, const sudoku_options* options, uint8_t* status) {
+    // 호출자가 더 오래된 구조체를 넘기면 모르는 필드는 기본값
+    sudoku_options opts;
+    sudoku_options_init(&opts);
+    if (options) memcpy(&opts, options, std::min((size_t)options->size, sizeof(opts)));
+
+    size_t stride = opts.input_stride ? opts.input_stride : 81;
+    // 모르는 엔진이나 변형으로 엉뚱하게 풀지 않도록 모든 퍼즐을 INVALID로 돌려줌
+    if (opts.engine < SUDOKU_ENGINE_LOGIC || opts.engine > SUDOKU_ENGINE_SEARCH
+        || opts.variant < SUDOKU_VARIANT_CLASSIC || opts.variant > SUDOKU_VARIANT_WINDOKU) {
+        for (size_t i = 0; i < n; i++) {
+            memcpy(out + i * 81, in + i * stride, 81);
+            if (status) status[i] = SUDOKU_INVALID;
+        }
+        return 0;
+    }
+
+    const Variant& variant = opts.variant == SUDOKU_VARIANT_X ? Variant::diagonal()
+        : opts.variant == SUDOKU_VARIANT_WINDOKU ? Variant::windoku() : Variant::classic();
+    bool hasBudget = opts.time_budget_ms != 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(opts.time_budget_ms);
+
+    ThreadState& state = threadState();
+    SudokuSolver& solver = state.solver;
+    solver.getGrid().setVariant(variant);
+    solver.setUseBacktrack(opts.engine != SUDOKU_ENGINE_LOGIC);
+    solver.setStrategies(opts.engine == SUDOKU_ENGINE_SEARCH ? 0 : opts.strategies);
+
+    size_t solved = 0;
+    for (size_t i = 0; i < n; i++) {
+        const char* puzzle = in + i * stride;
+        char* grid = out + i * 81;
+        uint8_t result;
+        if (hasBudget && std::chrono::steady_clock::now() >= deadline) {
+            result = SUDOKU_TIMEOUT;
+            memcpy(grid, puzzle, 81);
+        } else {
+            solver.reset();
+            state.scratch.reset();
+            if (!CorpusReader::parse(puzzle, puzzle + 81, solver.getGrid())) {
+                result = SUDOKU_INVALID;
+                memcpy(grid, puzzle, 81);
+            } else {
+                result = solver.solve() ? SUDOKU_SOLVED : SUDOKU_UNSOLVED;
+                formatGrid(solver.getGrid(), grid);
+            }
+        }
+        if (result == SUDOKU_SOLVED) solved++;
+        if (status) status[i] = result;
+    }
+    return solved;
+}
+
+} // extern "C"
@@ -0,0 +1,86 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+/* 다른 언어에서 FFI로 부르는 C ABI (sudoku.dll / libsudoku.so).
+ *
+ * 버퍼는 모두 호출자 것이고, 라이브러리는 호출한 스레드에서 풀며 스레드마다 솔버와 탐색
+ * 스크래치를 한 번만 만들어 돌려 쓰므로 퍼즐마다 할당하지 않음. 여러 스레드에서 동시에 불러도 됨.
+ * 구조체에는 필드를 뒤에만 추가하고, 값은 바꾸지 않음 */
+
+#if defined(_WIN32)
+#  if defined(SUDOKU_API_EXPORTS)
+#    define SUDOKU_API __declspec(dllexport)
+#  else
+#    define SUDOKU_API __declspec(dllimport)
+#  endif
+#else
+#  define SUDOKU_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SUDOKU_API_VERSION 1
+
+/* 퍼즐별 결과 (서비스 응답의 상태와 같은 값) */
+enum {
+    SUDOKU_SOLVED = 0,
+    SUDOKU_UNSOLVED = 1,    /* 고른 전략으로는 다 못 채움, 출력은 채운 데까지 */
+    SUDOKU_INVALID = 2,     /* 81글자 중 '.', '0'-'9' 밖의 글자가 있거나 규칙 위반, 또는 options의
+                               engine/variant가 범위 밖 (모든 퍼즐). 출력은 입력 그대로 */
+    SUDOKU_TIMEOUT = 3,     /* 시간 예산을 넘겨 시작하지 않음, 출력은 입력 그대로 */
+};
+
+enum {
+    SUDOKU_ENGINE_LOGIC = 0,        /* 논리 전략만 */
+    SUDOKU_ENGINE_HYBRID = 1,       /* 논리 전략 뒤 못 풀면 백트래킹 */
+    SUDOKU_ENGINE_SEARCH = 2,       /* 백트래킹만 (전략 집합 무시) */
+};
+
+enum {
+    SUDOKU_VARIANT_CLASSIC = 0,
+    SUDOKU_VARIANT_X = 1,           /* 두 대각선 */
+    SUDOKU_VARIANT_WINDOKU = 2,     /* 3x3 창 4개 */
+};
+
+/* 전략 집합 비트 (적용 순서는 고정, 꺼진 전략만 건너뜀) */
+#define SUDOKU_STRATEGY_NAKED_SINGLE        (1u << 0)
+#define SUDOKU_STRATEGY_HIDDEN_SINGLE       (1u << 1)
+#define SUDOKU_STRATEGY_NAKED_PAIR          (1u << 2)
+#define SUDOKU_STRATEGY_NAKED_TRIPLE        (1u << 3)
+#define SUDOKU_STRATEGY_HIDDEN_PAIR         (1u << 4)
+#define SUDOKU_STRATEGY_HIDDEN_TRIPLE       (1u << 5)
+#define SUDOKU_STRATEGY_POINTING_PAIR       (1u << 6)
+#define SUDOKU_STRATEGY_BOX_LINE_REDUCTION  (1u << 7)
+#define SUDOKU_STRATEGY_X_WING              (1u << 8)
+#define SUDOKU_STRATEGY_SWORDFISH           (1u << 9)
+#define SUDOKU_STRATEGY_Y_WING              (1u << 10)
+#define SUDOKU_STRATEGY_FORCING_CHAIN       (1u << 11)
+#define SUDOKU_STRATEGY_BASIC               (SUDOKU_STRATEGY_NAKED_SINGLE | SUDOKU_STRATEGY_HIDDEN_SINGLE)
+#define SUDOKU_STRATEGY_ALL                 0xFFFu
+
+typedef struct sudoku_options {
+    uint32_t size;              /* sizeof(sudoku_options), sudoku_options_init이 채움 */
+    int32_t engine;             /* SUDOKU_ENGINE_* (기본: HYBRID) */
+    uint32_t strategies;        /* SUDOKU_STRATEGY_* 조합 (기본: ALL) */
+    int32_t variant;            /* SUDOKU_VARIANT_* (기본: CLASSIC) */
+    uint32_t time_budget_ms;    /* 호출 전체의 예산, 넘기면 남은 퍼즐은 TIMEOUT (0 = 없음) */
+    uint32_t input_stride;      /* 입력 퍼즐 사이 간격 바이트 (0 = 81, 줄 단위 텍스트면 82) */
+} sudoku_options;
+
+SUDOKU_API int sudoku_api_version(void);
+
+/* 기본값으로 채움 */
+SUDOKU_API void sudoku_options_init(sudoku_options* options);
+
+/* in: n개 퍼즐 (81글자, '.'/'0' = 빈칸), out: n * 81바이트 ('.' = 못 채운 칸, 끝에 NUL 없음),
+ * status: n바이트 (NULL이면 기록 안 함), options: NULL이면 기본값.
+ * 반환: 푼 퍼즐 수 (engine이나 variant가 모르는 값이면 0) */
+SUDOKU_API size_t sudoku_solve_batch(const char* in, char* out, size_t n,
+    const sudoku_options* options, uint8_t* status);
+
+#ifdef __cplusplus
+}
+#endif
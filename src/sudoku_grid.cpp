@@ -1,16 +1,23 @@
 #include "sudoku_grid.h"
 
-SudokuGrid::SudokuGrid() { reset(); }
+SudokuGrid::SudokuGrid() : variant(&Variant::classic()) { reset(); }
+
+SudokuGrid::SudokuGrid(const Variant& v) : variant(&v) { reset(); }
 
 void SudokuGrid::reset() {
     for (auto& row : grid) row.fill(0);
     for (auto& row : candidates) row.fill(0x1FF);
     for (auto& row : isOriginal) row.fill(false);
-    rowMask.fill(0); colMask.fill(0); boxMask.fill(0);
+    unitMask.fill(0);
+}
+
+void SudokuGrid::setVariant(const Variant& v) {
+    variant = &v;
+    reset();
 }
 
 int SudokuGrid::getBoxIndex(int row, int col) const { 
-    return (row / 3) * 3 + (col / 3); 
+    return variant->region(row * 9 + col); 
 }
 
 int SudokuGrid::getValue(int row, int col) const { 
@@ -28,47 +35,62 @@ void SudokuGrid::setCandidates(int row, int col, int cand) {
 void SudokuGrid::setCell(int row, int col, int num) {
     grid[row][col] = num;
     int bit = 1 << (num - 1);
-    rowMask[row] |= bit; 
-    colMask[col] |= bit; 
-    boxMask[getBoxIndex(row, col)] |= bit;
+    int cell = row * 9 + col;
+    const uint8_t* units = variant->cellUnits(cell);
+    for (int k = 0; k < variant->cellUnitCount(cell); k++) unitMask[units[k]] |= bit;
     candidates[row][col] = 0;
     
-    for (int i = 0; i < 9; i++) {
-        candidates[row][i] &= ~bit;
-        candidates[i][col] &= ~bit;
+    const uint8_t* peers = variant->peers(cell);
+    for (int k = 0; k < variant->peerCount(cell); k++) {
+        candidates[peers[k] / 9][peers[k] % 9] &= ~bit;
     }
-    int br = (row / 3) * 3, bc = (col / 3) * 3;
-    for (int i = 0; i < 3; i++)
-        for (int j = 0; j < 3; j++)
-            candidates[br + i][bc + j] &= ~bit;
 }
 
 void SudokuGrid::clearCell(int row, int col, int num) {
     grid[row][col] = 0;
     int bit = 1 << (num - 1);
-    rowMask[row] &= ~bit; 
-    colMask[col] &= ~bit; 
-    boxMask[getBoxIndex(row, col)] &= ~bit;
+    int cell = row * 9 + col;
+    const uint8_t* units = variant->cellUnits(cell);
+    for (int k = 0; k < variant->cellUnitCount(cell); k++) unitMask[units[k]] &= ~bit;
+    candidates[row][col] = ~getUsedMask(row, col) & 0x1FF;
+
+    // 이 숫자를 막던 것이 이 칸뿐인 이웃에만 후보를 되돌림 (다른 유닛이나 케이지가 아직 막으면 그대로)
+    const uint8_t* peers = variant->peers(cell);
+    for (int k = 0; k < variant->peerCount(cell); k++) {
+        int r = peers[k] / 9, c = peers[k] % 9;
+        if (grid[r][c] == 0 && !(getUsedMask(r, c) & bit)) candidates[r][c] |= bit;
+    }
 }
 
 void SudokuGrid::setValue(int row, int col, int num, bool original) {
-    if (grid[row][col] != 0) {
-        int old = grid[row][col];
-        clearCell(row, col, old);
-        updateCandidates();
-    }
+    if (grid[row][col] != 0) clearCell(row, col, grid[row][col]);
     if (num >= 1 && num <= 9) {
         setCell(row, col, num);
         if (original) isOriginal[row][col] = true;
     } else {
         isOriginal[row][col] = false;
-        updateCandidates();
     }
 }
 
 bool SudokuGrid::isValidMove(int row, int col, int num) const {
     int bit = 1 << (num - 1);
-    return !((rowMask[row] | colMask[col] | boxMask[getBoxIndex(row, col)]) & bit);
+    return !(getUsedMask(row, col) & bit);
+}
+
+int SudokuGrid::getUsedMask(int row, int col) const {
+    int cell = row * 9 + col;
+    const uint8_t* units = variant->cellUnits(cell);
+    int used = 0;
+    for (int k = 0; k < variant->cellUnitCount(cell); k++) used |= unitMask[units[k]];
+    int cage = variant->cageOf(cell);
+    if (cage >= 0) {
+        const Variant::Cage& c = variant->cage(cage);
+        for (int m = 0; m < c.size; m++) {
+            int val = grid[c.cells[m] / 9][c.cells[m] % 9];
+            if (val) used |= 1 << (val - 1);
+        }
+    }
+    return used;
 }
 
 bool SudokuGrid::isComplete() const {
@@ -89,7 +111,7 @@ void SudokuGrid::updateCandidates() {
     for (int i = 0; i < 9; i++) {
         for (int j = 0; j < 9; j++) {
             if (grid[i][j] == 0) {
-                candidates[i][j] = ~(rowMask[i] | colMask[j] | boxMask[getBoxIndex(i, j)]) & 0x1FF;
+                candidates[i][j] = ~getUsedMask(i, j) & 0x1FF;
             } else {
                 candidates[i][j] = 0;
             }
@@ -1,23 +1,32 @@
 #pragma once
 #include <array>
+#include "variant.h"
 
 class SudokuGrid {
 private:
     std::array<std::array<int, 9>, 9> grid;
     std::array<std::array<int, 9>, 9> candidates;
-    std::array<int, 9> rowMask, colMask, boxMask;
+    std::array<int, Variant::MAX_UNITS> unitMask;
+    const Variant* variant;     // 그리드보다 오래 살아야 함
 
 public:
     std::array<std::array<bool, 9>, 9> isOriginal;
 
     SudokuGrid();
+    explicit SudokuGrid(const Variant& v);
     void reset();
     
+    // 유닛 표를 바꾸고 비움
+    void setVariant(const Variant& v);
+    const Variant& getVariant() const { return *variant; }
+    
     int getBoxIndex(int row, int col) const;
     int getValue(int row, int col) const;
     int getCandidates(int row, int col) const;
     void setCandidates(int row, int col, int cand);
     
+    // 놓고 지우는 것은 서로 되돌림: 후보가 놓인 숫자로만 정해진 상태면 지운 뒤에도 그대로 유지됨
+    // (전략이 지운 후보는 되살리지 않으므로 필요하면 updateCandidates())
     void setCell(int row, int col, int num);
     void clearCell(int row, int col, int num);
     void setValue(int row, int col, int num, bool original = false);
@@ -30,7 +39,10 @@ public:
     static int countBits(int mask);
     
     // 마스크 접근자
-    int getRowMask(int row) const { return rowMask[row]; }
-    int getColMask(int col) const { return colMask[col]; }
-    int getBoxMask(int idx) const { return boxMask[idx]; }
+    int getRowMask(int row) const { return unitMask[row]; }
+    int getColMask(int col) const { return unitMask[9 + col]; }
+    int getBoxMask(int idx) const { return unitMask[18 + idx]; }
+    int getUnitMask(int unit) const { return unitMask[unit]; }
+    // 칸이 속한 모든 유닛과 케이지에 이미 놓인 숫자
+    int getUsedMask(int row, int col) const;
 };
@@ -0,0 +1,190 @@
+#include "telemetry.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+namespace Telemetry {
+
+namespace {
+
+const int SUB = 1 << SUB_BITS;
+const int HALF = SUB / 2;
+
+// Prometheus 히스토그램 경계 (초)
+const double LE_BOUNDS[] = { 0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10 };
+const double QUANTILES[] = { 0.5, 0.9, 0.99, 0.999 };
+const char* RESULT_NAMES[] = { "solved", "unsolved", "invalid", "timeout" };
+
+void appendMs(uint64_t ns, std::string& out) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.3fms", ns / 1e6);
+    out += buf;
+}
+
+void appendHeader(std::string& out, const char* name, const char* help, const char* type) {
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+}
+
+} // namespace
+
+int bucketOf(uint64_t ns) {
+    if (ns < (uint64_t)SUB) return (int)ns;
+    if (ns >> MAX_BITS) return BUCKETS - 1;
+    int msb = SUB_BITS;
+    while (ns >> (msb + 1)) msb++;
+    int shift = msb - (SUB_BITS - 1);   // ns >> shift는 [HALF, SUB)
+    return SUB + (shift - 1) * HALF + (int)((ns >> shift) - HALF);
+}
+
+uint64_t bucketUpper(int bucket) {
+    if (bucket < SUB) return (uint64_t)bucket;
+    int shift = (bucket - SUB) / HALF + 1;
+    uint64_t mantissa = (uint64_t)((bucket - SUB) % HALF + HALF);
+    return ((mantissa + 1) << shift) - 1;
+}
+
+Metrics::Metrics() {
+    for (auto& c : counters) c.store(0, std::memory_order_relaxed);
+    for (auto& b : buckets) b.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+}
+
+void Snapshot::add(const Metrics& m) {
+    for (int c = 0; c < COUNTER_COUNT; c++) counters[c] += m.counters[c].load(std::memory_order_relaxed);
+    for (int b = 0; b < BUCKETS; b++) {
+        uint64_t n = m.buckets[b].load(std::memory_order_relaxed);
+        buckets[b] += n;
+        count += n;
+    }
+    sum += m.sum.load(std::memory_order_relaxed);
+    uint64_t mx = m.max.load(std::memory_order_relaxed);
+    if (mx > max) max = mx;
+}
+
+uint64_t Snapshot::percentile(double q) const {
+    if (count == 0) return 0;
+    uint64_t rank = (uint64_t)(q * count + 0.5);
+    if (rank < 1) rank = 1;
+    uint64_t seen = 0;
+    for (int b = 0; b < BUCKETS; b++) {
+        seen += buckets[b];
+        // 칸 상한이 실제 최대보다 크면 최대를 보고
+        if (seen >= rank) return bucketUpper(b) < max ? bucketUpper(b) : max;
+    }
+    return max;
+}
+
+void formatReport(const Snapshot& s, double elapsedSeconds, double perSecond, std::string& out) {
+    char buf[256];
+    snprintf(buf, sizeof(buf), "[%.1fs] 처리 %llu (%.0f/s), 해결 %llu, 미해결 %llu, 오류 %llu, 시간 초과 %llu, 백트래킹 %llu, 지연 p50 ",
+        elapsedSeconds, (unsigned long long)s.total(), perSecond,
+        (unsigned long long)s.counters[Solved], (unsigned long long)s.counters[Unsolved],
+        (unsigned long long)s.counters[Invalid], (unsigned long long)s.counters[Timeout],
+        (unsigned long long)s.counters[Backtracked]);
+    out += buf;
+    appendMs(s.percentile(0.5), out);
+    out += " p99 ";
+    appendMs(s.percentile(0.99), out);
+    out += " p999 ";
+    appendMs(s.percentile(0.999), out);
+    out += " 최대 ";
+    appendMs(s.max, out);
+}
+
+bool writePrometheus(const Snapshot& s, double uptimeSeconds, const char* path) {
+    std::string text;
+    char buf[128];
+    appendHeader(text, "sudoku_puzzles_total", "결과별 처리한 퍼즐 수", "counter");
+    for (int c = Solved; c <= Timeout; c++) {
+        snprintf(buf, sizeof(buf), "sudoku_puzzles_total{result=\"%s\"} %llu\n", RESULT_NAMES[c], (unsigned long long)s.counters[c]);
+        text += buf;
+    }
+    appendHeader(text, "sudoku_backtrack_escalations_total", "백트래킹으로 넘어간 퍼즐 수", "counter");
+    snprintf(buf, sizeof(buf), "sudoku_backtrack_escalations_total %llu\n", (unsigned long long)s.counters[Backtracked]);
+    text += buf;
+
+    // 칸 상한이 경계 이하인 칸만 셈 (경계에 걸친 칸은 다음 경계로, 오차 1/64 이하)
+    appendHeader(text, "sudoku_solve_latency_seconds", "퍼즐 하나의 풀이 시간", "histogram");
+    int b = 0;
+    uint64_t cumulative = 0;
+    for (double le : LE_BOUNDS) {
+        uint64_t bound = (uint64_t)(le * 1e9);
+        while (b < BUCKETS && bucketUpper(b) <= bound) cumulative += s.buckets[b++];
+        snprintf(buf, sizeof(buf), "sudoku_solve_latency_seconds_bucket{le=\"%g\"} %llu\n", le, (unsigned long long)cumulative);
+        text += buf;
+    }
+    snprintf(buf, sizeof(buf), "sudoku_solve_latency_seconds_bucket{le=\"+Inf\"} %llu\n", (unsigned long long)s.count);
+    text += buf;
+    snprintf(buf, sizeof(buf), "sudoku_solve_latency_seconds_sum %.9f\n", s.sum / 1e9);
+    text += buf;
+    snprintf(buf, sizeof(buf), "sudoku_solve_latency_seconds_count %llu\n", (unsigned long long)s.count);
+    text += buf;
+
+    appendHeader(text, "sudoku_solve_latency_quantile_seconds", "히스토그램에서 구한 풀이 시간 분위수", "gauge");
+    for (double q : QUANTILES) {
+        snprintf(buf, sizeof(buf), "sudoku_solve_latency_quantile_seconds{quantile=\"%g\"} %.9f\n", q, s.percentile(q) / 1e9);
+        text += buf;
+    }
+    appendHeader(text, "sudoku_solve_latency_max_seconds", "가장 긴 풀이 시간", "gauge");
+    snprintf(buf, sizeof(buf), "sudoku_solve_latency_max_seconds %.9f\n", s.max / 1e9);
+    text += buf;
+    appendHeader(text, "sudoku_uptime_seconds", "시작부터 경과 시간", "gauge");
+    snprintf(buf, sizeof(buf), "sudoku_uptime_seconds %.3f\n", uptimeSeconds);
+    text += buf;
+
+    std::string tmp = std::string(path) + ".tmp";
+    FILE* f = fopen(tmp.c_str(), "wb");
+    if (!f) return false;
+    bool ok = fwrite(text.data(), 1, text.size(), f) == text.size();
+    if (fclose(f) != 0) ok = false;
+#ifdef _WIN32
+    if (ok) ok = MoveFileExA(tmp.c_str(), path, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    if (ok) ok = rename(tmp.c_str(), path) == 0;
+#endif
+    return ok;
+}
+
+Reporter::Reporter(double intervalSeconds, std::function<void(double)> tick) : callback(std::move(tick)) {
+    if (intervalSeconds <= 0) return;
+    thread = std::thread([this, intervalSeconds]() {
+        auto start = std::chrono::steady_clock::now();
+        auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(intervalSeconds));
+        auto next = start + interval;
+        std::unique_lock<std::mutex> lock(mtx);
+        while (!cv.wait_until(lock, next, [this]() { return stopping; })) {
+            lock.unlock();
+            callback(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            lock.lock();
+            next += interval;
+        }
+    });
+}
+
+Reporter::~Reporter() { stop(); }
+
+void Reporter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    cv.notify_all();
+    if (thread.joinable()) thread.join();
+}
+
+} // namespace Telemetry
@@ -0,0 +1,91 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// 풀이 지연 시간 히스토그램과 결과 카운터.
+// 워커마다 자기 Metrics에만 기록하고 (경합 없음), 보고할 때 Snapshot으로 합침
+namespace Telemetry {
+    enum Counter {
+        Solved,
+        Unsolved,
+        Invalid,
+        Timeout,
+        Backtracked,    // 논리 전략으로 안 풀려 백트래킹으로 넘어간 퍼즐
+        COUNTER_COUNT
+    };
+
+    // HDR 방식 구간: 128ns까지는 1ns 단위, 그 위는 2의 거듭제곱 구간마다 64칸 (상대 오차 1/64 이하).
+    // 2^40ns (약 18분)를 넘는 값은 마지막 칸에 들어감
+    const int SUB_BITS = 7;
+    const int MAX_BITS = 40;
+    const int BUCKETS = (1 << SUB_BITS) + (MAX_BITS - SUB_BITS) * (1 << (SUB_BITS - 1));
+    int bucketOf(uint64_t ns);
+    uint64_t bucketUpper(int bucket);   // 칸에 들어가는 가장 큰 값
+
+    // 한 스레드만 기록. 원자적 증가 대신 relaxed 읽기/쓰기라 기록 비용은 일반 변수와 같고,
+    // 다른 스레드는 기록 중에도 읽을 수 있음 (주기 보고용)
+    class Metrics {
+    public:
+        Metrics();
+        Metrics(const Metrics&) = delete;
+        Metrics& operator=(const Metrics&) = delete;
+
+        void count(Counter c) { bump(counters[c], 1); }
+        void recordLatency(uint64_t ns) {
+            bump(buckets[bucketOf(ns)], 1);
+            bump(sum, ns);
+            if (ns > max.load(std::memory_order_relaxed)) max.store(ns, std::memory_order_relaxed);
+        }
+
+    private:
+        friend struct Snapshot;
+        static void bump(std::atomic<uint64_t>& a, uint64_t n) {
+            a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+        std::atomic<uint64_t> counters[COUNTER_COUNT];
+        std::atomic<uint64_t> buckets[BUCKETS];
+        std::atomic<uint64_t> sum;
+        std::atomic<uint64_t> max;
+    };
+
+    struct Snapshot {
+        uint64_t counters[COUNTER_COUNT] = {};
+        uint64_t buckets[BUCKETS] = {};
+        uint64_t count = 0;         // 지연 시간을 기록한 퍼즐 수
+        uint64_t sum = 0;
+        uint64_t max = 0;
+
+        void add(const Metrics& m);
+        uint64_t total() const { return counters[Solved] + counters[Unsolved] + counters[Invalid] + counters[Timeout]; }
+        // 분위수 q (0-1)의 값 (그 칸의 상한, ns)
+        uint64_t percentile(double q) const;
+    };
+
+    // 한 줄 요약: 경과, 처리 수와 처리량, 결과별 수, p50/p99/p999/최대 지연
+    void formatReport(const Snapshot& s, double elapsedSeconds, double perSecond, std::string& out);
+    // Prometheus 텍스트 형식. 임시 파일에 쓰고 바꿔치기하므로 수집기가 반쯤 쓴 파일을 읽지 않음
+    bool writePrometheus(const Snapshot& s, double uptimeSeconds, const char* path);
+
+    // intervalSeconds마다 다른 스레드에서 tick(시작부터 경과 초)을 부름. stop()이나 소멸 시 멈춤
+    class Reporter {
+    public:
+        Reporter(double intervalSeconds, std::function<void(double)> tick);
+        ~Reporter();
+        Reporter(const Reporter&) = delete;
+        Reporter& operator=(const Reporter&) = delete;
+        void stop();
+
+    private:
+        std::function<void(double)> callback;
+        std::mutex mtx;
+        std::condition_variable cv;
+        bool stopping = false;
+        std::thread thread;
+    };
+}
@@ -0,0 +1,78 @@
+#include "trace.h"
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+namespace Trace {
+
+static_assert(sizeof(Record) == RECORD_SIZE && std::is_trivially_copyable<Record>::value, "Record는 고정 크기 POD");
+
+thread_local Recorder* activeRecorder = nullptr;
+
+void setRecorder(Recorder* recorder) { activeRecorder = recorder; }
+Recorder* getRecorder() { return activeRecorder; }
+
+Recorder::Recorder(size_t capacity) {
+    size_t size = 1;
+    while (size < capacity) size <<= 1;
+    ring.assign(size, Record());
+    mask = size - 1;
+}
+
+void Recorder::copyTo(std::vector<Record>& out) const {
+    size_t n = size();
+    out.reserve(out.size() + n);
+    for (size_t i = 0; i < n; i++) out.push_back(at(i));
+}
+
+void writeHeader(unsigned char* out) {
+    memset(out, 0, HEADER_SIZE);
+    memcpy(out, "SDKT", 4);
+    out[4] = (unsigned char)VERSION;
+    out[5] = (unsigned char)(VERSION >> 8);
+    out[6] = (unsigned char)RECORD_SIZE;
+    out[7] = (unsigned char)(RECORD_SIZE >> 8);
+}
+
+bool readHeader(const unsigned char* in, size_t size) {
+    if (size < HEADER_SIZE || memcmp(in, "SDKT", 4) != 0) return false;
+    uint16_t version = (uint16_t)(in[4] | (in[5] << 8));
+    uint16_t recordSize = (uint16_t)(in[6] | (in[7] << 8));
+    return version == VERSION && recordSize == RECORD_SIZE;
+}
+
+void appendBinary(const Record& record, std::string& out) {
+    unsigned char buf[RECORD_SIZE] = {};
+    for (int i = 0; i < 4; i++) {
+        buf[i] = (unsigned char)(record.puzzle >> (8 * i));
+        buf[4 + i] = (unsigned char)(record.step >> (8 * i));
+    }
+    buf[8] = (unsigned char)record.digits;
+    buf[9] = (unsigned char)(record.digits >> 8);
+    buf[10] = record.strategy;
+    buf[11] = record.kind;
+    buf[12] = record.cell;
+    out.append((const char*)buf, RECORD_SIZE);
+}
+
+void appendJson(const Record& record, std::string& out) {
+    char digits[20];
+    int n = 0;
+    for (int d = 1; d <= 9; d++) {
+        if (record.digits & (1 << (d - 1))) {
+            if (n) digits[n++] = ',';
+            digits[n++] = (char)('0' + d);
+        }
+    }
+    digits[n] = '\0';
+
+    char line[160];
+    int len = snprintf(line, sizeof(line),
+        "{\"puzzle\":%u,\"step\":%u,\"strategy\":%u,\"kind\":\"%s\",\"row\":%u,\"col\":%u,\"digits\":[%s]}\n",
+        (unsigned)record.puzzle, (unsigned)record.step, (unsigned)record.strategy,
+        record.kind == (uint8_t)Kind::Place ? "place" : "eliminate",
+        (unsigned)(record.cell / 9), (unsigned)(record.cell % 9), digits);
+    out.append(line, (size_t)len);
+}
+
+} // namespace Trace
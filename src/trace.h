@@ -0,0 +1,95 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "strategies.h"
+
+// 풀이 단계 기록 (힌트, 감사용)
+//
+// Strategies의 각 추론(칸 확정, 후보 제거)을 고정 크기 레코드로 미리 잡아 둔 링 버퍼에 남김.
+// SUDOKU_ENABLE_TRACE 없이 빌드하면 기록 코드가 모두 빠지고, 켜도 기록기가 없는 스레드는
+// 포인터 검사 하나만 함. 백트래킹의 시도/되돌림은 기록하지 않음.
+namespace Trace {
+#ifdef SUDOKU_ENABLE_TRACE
+    const bool COMPILED = true;
+#else
+    const bool COMPILED = false;
+#endif
+
+    enum class Kind : uint8_t {
+        Place,          // digits의 숫자로 확정
+        Eliminate,      // digits의 후보 제거
+    };
+
+    // 바이너리 출력도 이 배치 그대로 (리틀 엔디언)
+    struct Record {
+        uint32_t puzzle;        // begin()에 넘긴 번호 (배치에서는 원본 줄 번호)
+        uint32_t step;          // 같은 퍼즐 안에서 nextStep()으로 구분한 단계
+        uint16_t digits;        // 비트 = 1 << (숫자 - 1)
+        uint8_t strategy;       // Strategies::StrategyId
+        uint8_t kind;           // Kind
+        uint8_t cell;           // 행 * 9 + 열
+        uint8_t reserved[3];
+    };
+
+    const size_t RECORD_SIZE = 16;
+    const size_t HEADER_SIZE = 16;  // "SDKT", 버전 uint16, 레코드 크기 uint16, 예약 8바이트
+    const uint16_t VERSION = 1;
+
+    class Recorder {
+    public:
+        // capacity는 2의 거듭제곱으로 올림, 넘치면 오래된 레코드부터 덮어씀
+        explicit Recorder(size_t capacity = 1 << 16);
+
+        void begin(uint32_t puzzle) { current = puzzle; step = 0; }
+        void nextStep() { step++; }
+
+        void push(Strategies::StrategyId strategy, Kind kind, int row, int col, int digits) {
+            Record& r = ring[(size_t)(written++) & mask];
+            r.puzzle = current;
+            r.step = step;
+            r.digits = (uint16_t)digits;
+            r.strategy = (uint8_t)strategy;
+            r.kind = (uint8_t)kind;
+            r.cell = (uint8_t)(row * 9 + col);
+        }
+
+        size_t size() const { return written < ring.size() ? (size_t)written : ring.size(); }
+        uint64_t dropped() const { return written - size(); }
+        const Record& at(size_t i) const { return ring[(size_t)(written - size() + i) & mask]; }
+
+        // 남아 있는 레코드를 오래된 순서로 out 뒤에 추가
+        void copyTo(std::vector<Record>& out) const;
+        void clear() { written = 0; }
+
+    private:
+        std::vector<Record> ring;
+        size_t mask;
+        uint64_t written = 0;
+        uint32_t current = 0;
+        uint32_t step = 0;
+    };
+
+    // 현재 스레드의 기록기 (nullptr이면 기록 안 함)
+    void setRecorder(Recorder* recorder);
+    Recorder* getRecorder();
+    extern thread_local Recorder* activeRecorder;
+
+    void writeHeader(unsigned char* out);
+    bool readHeader(const unsigned char* in, size_t size);
+    void appendBinary(const Record& record, std::string& out);
+    // JSON Lines: 레코드 하나당 한 줄
+    void appendJson(const Record& record, std::string& out);
+}
+
+#ifdef SUDOKU_ENABLE_TRACE
+#define SUDOKU_TRACE(strategy, kind, row, col, digits) \
+    do { if (Trace::Recorder* rec_ = Trace::activeRecorder) rec_->push(strategy, kind, row, col, digits); } while (0)
+#define SUDOKU_TRACE_STEP() \
+    do { if (Trace::Recorder* rec_ = Trace::activeRecorder) rec_->nextStep(); } while (0)
+#else
+// sizeof 안의 식은 평가되지 않음 (미사용 경고만 막음)
+#define SUDOKU_TRACE(strategy, kind, row, col, digits) ((void)sizeof((strategy), (kind), (row), (col), (digits)))
+#define SUDOKU_TRACE_STEP() ((void)0)
+#endif
@@ -0,0 +1,209 @@
+#include "variant.h"
+
+namespace {
+
+const uint8_t* boxRegions() {
+    static uint8_t regions[81];
+    for (int i = 0; i < 81; i++) regions[i] = (uint8_t)((i / 27) * 3 + (i % 9) / 3);
+    return regions;
+}
+
+// 크기와 합으로 정렬한 숫자 조합 512개, (크기, 합)마다 시작 위치
+struct ComboTable {
+    uint16_t masks[512];
+    uint16_t start[10][47];     // [크기][합]부터 [크기][합 + 1]까지
+
+    ComboTable() {
+        int n = 0;
+        for (int size = 0; size <= 9; size++) {
+            for (int sum = 0; sum <= 45; sum++) {
+                start[size][sum] = (uint16_t)n;
+                for (int mask = 0; mask < 512; mask++) {
+                    int count = 0, total = 0;
+                    for (int d = 1; d <= 9; d++) {
+                        if (mask & (1 << (d - 1))) { count++; total += d; }
+                    }
+                    if (count == size && total == sum) masks[n++] = (uint16_t)mask;
+                }
+            }
+            start[size][46] = (uint16_t)n;
+        }
+    }
+};
+
+const ComboTable& comboTable() {
+    static const ComboTable table;
+    return table;
+}
+
+} // namespace
+
+const uint16_t* Variant::combos(int size, int sum, int& count) {
+    const ComboTable& t = comboTable();
+    if (size < 0 || size > 9 || sum < 0 || sum > 45) { count = 0; return t.masks; }
+    count = t.start[size][sum + 1] - t.start[size][sum];
+    return t.masks + t.start[size][sum];
+}
+
+Variant::Variant() { build(Kind::Classic, boxRegions()); }
+
+const Variant& Variant::classic() {
+    static const Variant v;
+    return v;
+}
+
+const Variant& Variant::diagonal() {
+    static const Variant v = []() { Variant d; d.build(Kind::Diagonal, boxRegions()); return d; }();
+    return v;
+}
+
+const Variant& Variant::windoku() {
+    static const Variant v = []() { Variant w; w.build(Kind::Windoku, boxRegions()); return w; }();
+    return v;
+}
+
+bool Variant::jigsaw(const char* regions, Variant& out) {
+    char labels[9];
+    int labelCount = 0, sizes[9] = {};
+    uint8_t ids[81];
+    for (int i = 0; i < 81; i++) {
+        char ch = regions[i];
+        if (ch == '\0' || ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r') return false;
+        int id = 0;
+        while (id < labelCount && labels[id] != ch) id++;
+        if (id == labelCount) {
+            if (labelCount == 9) return false;
+            labels[labelCount++] = ch;
+        }
+        if (++sizes[id] > 9) return false;
+        ids[i] = (uint8_t)id;
+    }
+    if (labelCount != 9) return false;
+    out.build(Kind::Jigsaw, ids);
+    return true;
+}
+
+bool Variant::killer(const char* cages, const int* sums, int sumCount, Variant& out) {
+    char labels[MAX_CAGES];
+    Cage list[MAX_CAGES];
+    int labelCount = 0;
+    for (int i = 0; i < 81; i++) {
+        char ch = cages[i];
+        if (ch == '\0' || ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r') return false;
+        int id = 0;
+        while (id < labelCount && labels[id] != ch) id++;
+        if (id == labelCount) {
+            labels[labelCount] = ch;
+            list[labelCount++].size = 0;
+        }
+        if (list[id].size == 9) return false;
+        list[id].cells[list[id].size++] = (uint8_t)i;
+    }
+    if (sumCount != labelCount) return false;
+    for (int k = 0; k < labelCount; k++) {
+        if (sums[k] < 0 || sums[k] > 45) return false;
+        list[k].sum = (uint8_t)sums[k];
+    }
+    out.build(Kind::Killer, boxRegions(), list, labelCount);
+    // 주어진 케이지와 45 규칙으로 만든 케이지 모두 그 크기로 만들 수 있는 합이어야 함
+    for (int k = 0; k < out.cagesCount; k++) {
+        int count;
+        combos(out.cageList[k].size, out.cageList[k].sum, count);
+        if (count == 0) return false;
+    }
+    return true;
+}
+
+void Variant::addUnit(const uint8_t* cells) {
+    int u = units++;
+    for (int k = 0; k < 9; k++) {
+        int cell = cells[k];
+        unitCells[u][k] = (uint8_t)cell;
+        cellUnitList[cell][cellUnitsCount[cell]++] = (uint8_t)u;
+        cellUnitBits[cell] |= 1u << u;
+    }
+}
+
+void Variant::build(Kind kind, const uint8_t* regions, const Cage* cages, int cageCount) {
+    type = kind;
+    units = 0;
+    for (int i = 0; i < 81; i++) {
+        cellUnitsCount[i] = 0;
+        cellUnitBits[i] = 0;
+        regionOf[i] = regions[i];
+        cageIndex[i] = -1;
+    }
+    givenCages = cagesCount = cageCount;
+    for (int k = 0; k < cageCount; k++) {
+        cageList[k] = cages[k];
+        for (int m = 0; m < cages[k].size; m++) cageIndex[cages[k].cells[m]] = (int8_t)k;
+    }
+
+    uint8_t cells[9];
+    for (int r = 0; r < 9; r++) {
+        for (int k = 0; k < 9; k++) cells[k] = (uint8_t)(r * 9 + k);
+        addUnit(cells);
+    }
+    for (int c = 0; c < 9; c++) {
+        for (int k = 0; k < 9; k++) cells[k] = (uint8_t)(k * 9 + c);
+        addUnit(cells);
+    }
+    for (int g = 0; g < 9; g++) {
+        int n = 0;
+        for (int i = 0; i < 81; i++) if (regions[i] == g) cells[n++] = (uint8_t)i;
+        addUnit(cells);
+    }
+    if (kind == Kind::Diagonal) {
+        for (int k = 0; k < 9; k++) cells[k] = (uint8_t)(k * 9 + k);
+        addUnit(cells);
+        for (int k = 0; k < 9; k++) cells[k] = (uint8_t)(k * 9 + 8 - k);
+        addUnit(cells);
+    } else if (kind == Kind::Windoku) {
+        const int corners[4] = { 1 * 9 + 1, 1 * 9 + 5, 5 * 9 + 1, 5 * 9 + 5 };
+        for (int corner : corners) {
+            for (int k = 0; k < 9; k++) cells[k] = (uint8_t)(corner + (k / 3) * 9 + k % 3);
+            addUnit(cells);
+        }
+    }
+
+    // 45 규칙: 행/열/박스 안에 통째로 든 케이지를 빼고 남은 칸들도 합이 정해진 케이지 (같은 유닛이라 중복 없음)
+    for (int u = 0; u < 27 && givenCages > 0; u++) {
+        Cage rest;
+        rest.size = 0;
+        int sum = 45;
+        for (int k = 0; k < 9; k++) {
+            int cell = unitCells[u][k];
+            const Cage& cage = cageList[cageIndex[cell]];
+            bool inside = true;
+            for (int m = 0; m < cage.size && inside; m++) inside = (cellUnitBits[cage.cells[m]] >> u) & 1;
+            if (!inside) rest.cells[rest.size++] = (uint8_t)cell;
+            else if (cage.cells[0] == cell) sum -= cage.sum;
+        }
+        if (rest.size == 0 || rest.size == 9) continue;
+        rest.sum = (uint8_t)(sum < 0 ? 0 : sum);
+        cageList[cagesCount++] = rest;
+    }
+
+    // 이웃: 같은 유닛의 다른 칸 (유닛 순서대로, 중복 없이), 그 뒤에 케이지 동료
+    for (int i = 0; i < 81; i++) {
+        peerSet[i].reset();
+        peersCount[i] = 0;
+        for (int k = 0; k < cellUnitsCount[i]; k++) {
+            const uint8_t* unitCellsK = unitCells[cellUnitList[i][k]];
+            for (int m = 0; m < 9; m++) {
+                int p = unitCellsK[m];
+                if (p == i || peerSet[i].test(p)) continue;
+                peerSet[i].set(p);
+                peerList[i][peersCount[i]++] = (uint8_t)p;
+            }
+        }
+        if (cageIndex[i] < 0) continue;
+        const Cage& cage = cageList[cageIndex[i]];
+        for (int m = 0; m < cage.size; m++) {
+            int p = cage.cells[m];
+            if (p == i || peerSet[i].test(p)) continue;
+            peerSet[i].set(p);
+            peerList[i][peersCount[i]++] = (uint8_t)p;
+        }
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <bitset>
+#include <cstdint>
+
+// 제약 유닛 표: 유닛 0-8 행, 9-17 열, 18-26 영역(박스 또는 직소 조각), 27부터 변형 유닛
+// (대각선 2개 또는 윈도쿠 창 4개). 전략과 탐색은 이 표만 보고 돌아감.
+// 킬러 퍼즐의 케이지는 크기가 제각각이라 유닛과 따로 두고, 케이지 동료는 이웃에 넣음
+class Variant {
+public:
+    enum class Kind : uint8_t {
+        Classic,
+        Diagonal,   // 두 대각선에도 1-9
+        Windoku,    // 3x3 창 4개에도 1-9
+        Jigsaw,     // 박스 대신 불규칙한 조각
+        Killer,     // 기본 퍼즐 + 합이 정해진 케이지 (케이지 안은 숫자 중복 없음)
+    };
+
+    struct Cage {
+        uint8_t size;
+        uint8_t sum;
+        uint8_t cells[9];
+    };
+
+    static const int MAX_UNITS = 31;
+    static const int MAX_CELL_UNITS = 5;    // 대각선 퍼즐의 가운데 칸: 행, 열, 박스, 대각선 2
+    static const int MAX_PEERS = 32;        // 킬러: 기본 이웃 20 + 케이지 동료 최대 8
+    static const int MAX_CAGES = 81 + 27;   // 주어진 케이지 + 45 규칙 케이지 (유닛마다 하나)
+
+    static const Variant& classic();
+    static const Variant& diagonal();
+    static const Variant& windoku();
+    // regions: 81글자, 같은 글자끼리 한 조각 (9칸씩 9조각). 잘못된 배치면 false
+    static bool jigsaw(const char* regions, Variant& out);
+    // cages: 81글자, 같은 글자끼리 한 케이지. sums: 글자가 처음 나온 순서대로 케이지의 합.
+    // 9칸을 넘는 케이지나 그 크기로 만들 수 없는 합이면 false
+    static bool killer(const char* cages, const int* sums, int sumCount, Variant& out);
+
+    // 크기 size, 합 sum인 서로 다른 숫자 조합 (비트 = 1 << (숫자 - 1)), 없으면 count = 0
+    static const uint16_t* combos(int size, int sum, int& count);
+
+    Variant();  // 기본 퍼즐
+
+    Kind kind() const { return type; }
+    int unitCount() const { return units; }
+    const uint8_t* unit(int u) const { return unitCells[u]; }
+    // 칸이 속한 유닛 (오름차순)과 그 비트 집합
+    int cellUnitCount(int cell) const { return cellUnitsCount[cell]; }
+    const uint8_t* cellUnits(int cell) const { return cellUnitList[cell]; }
+    uint32_t unitBits(int cell) const { return cellUnitBits[cell]; }
+    int peerCount(int cell) const { return peersCount[cell]; }
+    const uint8_t* peers(int cell) const { return peerList[cell]; }
+    bool sees(int a, int b) const { return peerSet[a].test(b); }
+    int region(int cell) const { return regionOf[cell]; }
+    // 케이지 0부터 givenCageCount() 전까지는 주어진 것, 그 뒤는 45 규칙으로 만든 것
+    // (행/열/박스에서 그 안에 통째로 든 케이지를 뺀 나머지 칸)
+    int cageCount() const { return cagesCount; }
+    int givenCageCount() const { return givenCages; }
+    const Cage& cage(int k) const { return cageList[k]; }
+    int cageOf(int cell) const { return cageIndex[cell]; }  // 주어진 케이지, 없으면 -1
+
+private:
+    void build(Kind kind, const uint8_t* regions, const Cage* cages = nullptr, int cageCount = 0);
+    void addUnit(const uint8_t* cells);
+
+    Kind type;
+    int units;
+    uint8_t unitCells[MAX_UNITS][9];
+    uint8_t cellUnitList[81][MAX_CELL_UNITS];
+    uint8_t cellUnitsCount[81];
+    uint32_t cellUnitBits[81];
+    uint8_t peerList[81][MAX_PEERS];
+    uint8_t peersCount[81];
+    std::bitset<81> peerSet[81];
+    uint8_t regionOf[81];
+    int cagesCount;
+    int givenCages;
+    int8_t cageIndex[81];
+    Cage cageList[MAX_CAGES];
+};
@@ -0,0 +1,109 @@
+#include "verifier.h"
+#include "strategies.h"
+
+namespace Verifier {
+
+namespace {
+
+const char* KIND_NAMES[] = { "invalid-output", "wrong-solution", "false-solution", "missed-solution", "wrong-placement" };
+
+bool sameValues(const SudokuGrid& a, const SudokuGrid& b) {
+    for (int i = 0; i < 81; i++) {
+        if (a.getValue(i / 9, i % 9) != b.getValue(i / 9, i % 9)) return false;
+    }
+    return true;
+}
+
+// 해가 둘 이상이면 다른 엔진과 해가 달라도 틀린 것이 아님
+bool unique(const SudokuGrid& puzzle) {
+    return Strategies::countSolutions(puzzle, 2) == 1;
+}
+
+} // namespace
+
+const char* kindName(Kind kind) {
+    return KIND_NAMES[(int)kind];
+}
+
+bool isValidSolution(const SudokuGrid& puzzle, const SudokuGrid& grid) {
+    const Variant& v = puzzle.getVariant();
+    for (int i = 0; i < 81; i++) {
+        int given = puzzle.getValue(i / 9, i % 9);
+        int val = grid.getValue(i / 9, i % 9);
+        if (val < 1 || val > 9 || (given && given != val)) return false;
+    }
+    // 9칸에 9개 숫자가 모두 있으면 중복도 없음
+    for (int u = 0; u < v.unitCount(); u++) {
+        const uint8_t* cells = v.unit(u);
+        int mask = 0;
+        for (int k = 0; k < 9; k++) mask |= 1 << (grid.getValue(cells[k] / 9, cells[k] % 9) - 1);
+        if (mask != 0x1FF) return false;
+    }
+    for (int k = 0; k < v.givenCageCount(); k++) {
+        const Variant::Cage& cage = v.cage(k);
+        int mask = 0, sum = 0;
+        for (int m = 0; m < cage.size; m++) {
+            int val = grid.getValue(cage.cells[m] / 9, cage.cells[m] % 9);
+            mask |= 1 << (val - 1);
+            sum += val;
+        }
+        if (SudokuGrid::countBits(mask) != cage.size || sum != cage.sum) return false;
+    }
+    return true;
+}
+
+bool sampled(const SudokuGrid& puzzle, double rate) {
+    if (rate >= 1.0) return true;
+    if (rate <= 0.0) return false;
+    // FNV-1a 뒤에 섞어 상위 비트를 고르게 함
+    uint64_t h = 1469598103934665603ull;
+    for (int i = 0; i < 81; i++) {
+        h ^= (uint64_t)puzzle.getValue(i / 9, i % 9);
+        h *= 1099511628211ull;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    return (double)(h >> 11) < rate * (double)(1ull << 53);
+}
+
+bool compare(const SudokuGrid& puzzle, bool solved, bool exhaustive, const SudokuGrid& output,
+    Reference reference, Arena& scratch, SudokuGrid& referenceGrid, Kind& kind) {
+    referenceGrid = puzzle;
+    bool refSolved;
+    if (reference == Reference::Search) {
+        refSolved = Strategies::backtrack(referenceGrid, scratch);
+    } else {
+        refSolved = false;
+        Strategies::enumerateSolutions(puzzle, [&](const SudokuGrid& g) {
+            referenceGrid = g;
+            refSolved = true;
+            return false;
+        });
+    }
+
+    if (solved && !refSolved) {
+        kind = Kind::FalseSolution;
+        return true;
+    }
+    if (!solved && exhaustive && refSolved) {
+        kind = Kind::MissedSolution;
+        return true;
+    }
+    if (!refSolved || sameValues(output, referenceGrid)) return false;
+    if (solved) {
+        kind = Kind::WrongSolution;
+        return unique(puzzle);
+    }
+    // 논리 전략만으로 멈춘 그리드: 놓인 값이 유일해와 다르면 잘못된 추론
+    for (int i = 0; i < 81; i++) {
+        int val = output.getValue(i / 9, i % 9);
+        if (val && val != referenceGrid.getValue(i / 9, i % 9)) {
+            kind = Kind::WrongPlacement;
+            return unique(puzzle);
+        }
+    }
+    return false;
+}
+
+} // namespace Verifier
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include "arena.h"
+#include "sudoku_grid.h"
+
+// 최적화한 풀이 경로(전략 파이프라인, 해답 캐시)를 기준 엔진과 맞춰 보는 차등 검증.
+// 내놓은 해는 모두 유닛 규칙으로 확인하고, 표본으로 뽑은 퍼즐은 기준 엔진으로 다시 풀어 비교
+namespace Verifier {
+    enum class Reference {
+        Search,     // Strategies::backtrack (충돌 원인 되돌아가기 + nogood)
+        Simple,     // 후보가 적은 칸부터 고르는 단순 깊이 우선 탐색 (countSolutions와 같은 방식)
+    };
+
+    enum class Kind : uint8_t {
+        InvalidOutput,  // 해라고 내놓은 그리드가 유닛 규칙이나 단서와 맞지 않음
+        WrongSolution,  // 유일해 퍼즐인데 기준 엔진과 해가 다름
+        FalseSolution,  // 풀었다고 했지만 기준 엔진은 해가 없다고 함
+        MissedSolution, // 백트래킹까지 해서 해가 없다고 했지만 기준 엔진은 풂
+        WrongPlacement, // 다 못 풀고 멈춘 그리드에 유일해와 다른 값이 놓임
+    };
+    const char* kindName(Kind kind);
+
+    struct Mismatch {
+        uint64_t line;          // 텍스트 입력은 청크 기준 (Batch가 전체 기준으로 바꿈)
+        Kind kind;
+        char puzzle[81];
+        char output[81];
+        char reference[81];     // 기준 엔진이 못 풀었으면 퍼즐 그대로
+    };
+
+    // 모든 칸이 차 있고, 모든 유닛(과 킬러 케이지)이 숫자를 한 번씩만 쓰며, 퍼즐의 단서를 지키는지.
+    // 그리드가 저장한 마스크는 믿지 않고 값에서 다시 계산
+    bool isValidSolution(const SudokuGrid& puzzle, const SudokuGrid& grid);
+
+    // 퍼즐 내용의 해시로 정하는 표본 (같은 퍼즐은 실행이나 스레드와 상관없이 늘 같은 결정)
+    bool sampled(const SudokuGrid& puzzle, double rate);
+
+    // 주 엔진의 결과를 기준 엔진으로 다시 푼 결과와 비교해 불일치면 true와 종류.
+    // exhaustive: 주 엔진이 백트래킹까지 했음 (못 풀었다면 해가 없다는 뜻)
+    bool compare(const SudokuGrid& puzzle, bool solved, bool exhaustive, const SudokuGrid& output,
+        Reference reference, Arena& scratch, SudokuGrid& referenceGrid, Kind& kind);
+}